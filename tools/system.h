@@ -0,0 +1,2 @@
+/* Host builds of the tools which link ugui.c */
+#include <stdint.h>
@@ -0,0 +1,867 @@
+/* -------------------------------------------------------------------------------- */
+/* -- µGUI font converter                                                        -- */
+/* -------------------------------------------------------------------------------- */
+// Host-side tool which reads one of the 1bpp font tables from ugui.c or a
+// PSF console font and writes it as a C source file in another font format.
+//
+// Build:  cc -O2 -o ugui_fontconv ugui_fontconv.c
+// Usage:  ugui_fontconv [-u] [-b] [-s N] <mode> <ugui.c> <font_WxH> <NAME> [output.c [source ...]]
+//         ugui_fontconv [-u] [-b] [-s N] <mode> <font.psf> psf <NAME> [output.c [source ...]]
+//
+// The font table is looked up by its array name (e.g. font_32x53); the glyph
+// size is taken from the name. PSF fonts (version 1 and 2) are mapped through
+// their unicode table if they have one. NAME is the name of the generated
+// UG_FONT.
+//
+// Modes:
+//    1bpp         FONT_TYPE_1BPP (with -b)
+//    rle          FONT_TYPE_1BPP_RLE: nibble run lengths, identical rows merged
+//    subset       FONT_TYPE_1BPP with only the characters used by the sources
+//    subset-rle   FONT_TYPE_1BPP_RLE with only the characters used by the sources
+//    aa4          FONT_TYPE_4BPP, the font scaled down by N (-s, default 2)
+//    aa2          FONT_TYPE_2BPP, the font scaled down by N (-s, default 2)
+//
+// -b trims every glyph of the 1bpp modes to its ink box (UG_FONT_BBOX), so
+// empty rows and columns are neither stored nor drawn. Its tables are named
+// <font>_<mode>_bb instead of <font>_<mode>.
+//
+// The anti-aliased modes take the coverage of each N x N block of the source
+// glyph, so e.g. font_32x53 becomes a 16x27 font with smooth edges.
+//
+// The subset modes collect all characters of the string and character
+// literals in C sources (.c, .h, .cpp); any other source is read as plain text
+// (e.g. a string table). -u decodes the sources as UTF-8 (USE_UTF8), otherwise
+// every byte is a Latin-1 character. Characters which are only produced at
+// run time, like the digits of printed numbers, are added with a plain text
+// source. The generated font maps the characters to the glyphs through a
+// sorted UG_FONT_RANGE table.
+/* -------------------------------------------------------------------------------- */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+#define GLYPHS 256
+#define CODES 0x10000
+
+static int width;
+static int height;
+static int bytes_per_row;
+static int glyph_count;
+static unsigned char* font;
+static int unicode[CODES];
+
+/* Glyphs to convert, in output order, and their character codes */
+static int glyphs[CODES];
+static unsigned int codes[CODES];
+static int count;
+static unsigned char used[CODES];
+static int utf8;
+static int scale = 2;
+static int trim;
+
+/* Ink box (x, y, w, h) of every converted glyph */
+static int box[CODES][4];
+
+static unsigned char* out;
+static size_t out_len;
+static size_t out_size;
+static unsigned long offsets[CODES];
+
+static void emit( unsigned char b )
+{
+   if ( out_len == out_size )
+   {
+      out_size = out_size ? out_size*2 : 4096;
+      out = realloc( out, out_size );
+      if ( out == NULL )
+      {
+         fprintf( stderr, "out of memory\n" );
+         exit( 1 );
+      }
+   }
+   out[out_len++] = b;
+}
+
+/* Bits are stored LSB first, each row starts at a byte boundary */
+static int pixel( int g, int x, int y )
+{
+   const unsigned char* p = &font[(size_t)g * height * bytes_per_row + y * bytes_per_row];
+   return (p[x >> 3] >> (x & 7)) & 1;
+}
+
+static int load_font( const char* file, const char* name )
+{
+   FILE* f;
+   char line[4096];
+   char key[64];
+   char* s;
+   size_t n,size;
+   int found;
+
+   if ( sscanf( name, "font_%dx%d", &width, &height ) != 2 )
+   {
+      fprintf( stderr, "%s: font name must look like font_WxH\n", name );
+      return -1;
+   }
+   bytes_per_row = (width + 7) / 8;
+   size = (size_t)GLYPHS * height * bytes_per_row;
+   font = calloc( size, 1 );
+   if ( font == NULL ) return -1;
+
+   f = fopen( file, "r" );
+   if ( f == NULL )
+   {
+      perror( file );
+      return -1;
+   }
+
+   snprintf( key, sizeof(key), "unsigned char %s[", name );
+   found = 0;
+   n = 0;
+   while ( fgets( line, sizeof(line), f ) != NULL )
+   {
+      if ( !found )
+      {
+         if ( strstr( line, key ) != NULL ) found = 1;
+         continue;
+      }
+      if ( strstr( line, "};" ) == line ) break;
+
+      /* Strip trailing comments, they contain the character codes */
+      s = strstr( line, "//" );
+      if ( s != NULL ) *s = 0;
+      s = line;
+      while ( (s = strstr( s, "0x" )) != NULL )
+      {
+         if ( n < size ) font[n] = (unsigned char)strtoul( s, NULL, 16 );
+         n++;
+         s += 2;
+      }
+   }
+   fclose( f );
+
+   if ( !found )
+   {
+      fprintf( stderr, "%s: font table %s not found\n", file, name );
+      return -1;
+   }
+   if ( n != size )
+   {
+      fprintf( stderr, "%s: expected %lu bytes, found %lu\n", name, (unsigned long)size, (unsigned long)n );
+      return -1;
+   }
+   glyph_count = GLYPHS;
+
+   /* Same as _UG_GetGlyph(): the built-in fonts use code page 437 */
+   for(n=0;n<CODES;n++) unicode[n] = ( n < GLYPHS ) ? (int)n : -1;
+   unicode[0xF6] = 0x94; unicode[0xD6] = 0x99;
+   unicode[0xFC] = 0x81; unicode[0xDC] = 0x9A;
+   unicode[0xE4] = 0x84; unicode[0xC4] = 0x8E;
+   unicode[0xB5] = 0xE6; unicode[0xB0] = 0xF8;
+   return 0;
+}
+
+static unsigned long read32( const unsigned char* p )
+{
+   return p[0] | (p[1] << 8) | ((unsigned long)p[2] << 16) | ((unsigned long)p[3] << 24);
+}
+
+/* Decodes one UTF-8 sequence, returns the number of bytes or 0 if invalid */
+static int decode_utf8( const unsigned char* p, size_t n, unsigned int* c )
+{
+   int len,i;
+
+   if ( p[0] < 0x80 ) { *c = p[0]; return 1; }
+   if ( (p[0] & 0xE0) == 0xC0 ) { *c = p[0] & 0x1F; len = 2; }
+   else if ( (p[0] & 0xF0) == 0xE0 ) { *c = p[0] & 0x0F; len = 3; }
+   else if ( (p[0] & 0xF8) == 0xF0 ) { *c = p[0] & 0x07; len = 4; }
+   else return 0;
+   if ( (size_t)len > n ) return 0;
+   for(i=1;i<len;i++)
+   {
+      if ( (p[i] & 0xC0) != 0x80 ) return 0;
+      *c = (*c << 6) | (p[i] & 0x3F);
+   }
+   return len;
+}
+
+/* PSF rows are stored MSB first, µGUI fonts LSB first */
+static unsigned char reverse( unsigned char b )
+{
+   b = ((b & 0xF0) >> 4) | ((b & 0x0F) << 4);
+   b = ((b & 0xCC) >> 2) | ((b & 0x33) << 2);
+   return ((b & 0xAA) >> 1) | ((b & 0x55) << 1);
+}
+
+static int load_psf( const char* file )
+{
+   FILE* f;
+   unsigned char* buf;
+   unsigned char* p;
+   size_t n,size,header,glyph_size,i;
+   unsigned int c;
+   int has_table,g,psf2,len;
+
+   f = fopen( file, "rb" );
+   if ( f == NULL )
+   {
+      perror( file );
+      return -1;
+   }
+   fseek( f, 0, SEEK_END );
+   n = ftell( f );
+   fseek( f, 0, SEEK_SET );
+   buf = malloc( n + 1 );
+   if ( (buf == NULL) || (fread( buf, 1, n, f ) != n) )
+   {
+      perror( file );
+      return -1;
+   }
+   fclose( f );
+
+   if ( (n >= 4) && (buf[0] == 0x36) && (buf[1] == 0x04) )
+   {
+      psf2 = 0;
+      header = 4;
+      width = 8;
+      height = buf[3];
+      glyph_count = ( buf[2] & 0x01 ) ? 512 : 256;
+      glyph_size = height;
+      has_table = buf[2] & 0x02;
+   }
+   else if ( (n >= 32) && (read32( buf ) == 0x864AB572) )
+   {
+      psf2 = 1;
+      header = read32( buf + 8 );
+      glyph_count = read32( buf + 16 );
+      glyph_size = read32( buf + 20 );
+      height = read32( buf + 24 );
+      width = read32( buf + 28 );
+      has_table = read32( buf + 12 ) & 0x01;
+   }
+   else
+   {
+      fprintf( stderr, "%s: not a PSF font\n", file );
+      return -1;
+   }
+   bytes_per_row = (width + 7) / 8;
+   if ( (glyph_count <= 0) || (glyph_count > CODES) || (glyph_size != (size_t)height * bytes_per_row) ||
+        (header + glyph_count * glyph_size > n) )
+   {
+      fprintf( stderr, "%s: unsupported PSF header\n", file );
+      return -1;
+   }
+
+   size = (size_t)glyph_count * glyph_size;
+   font = malloc( size );
+   if ( font == NULL ) return -1;
+   for(i=0;i<size;i++) font[i] = reverse( buf[header + i] );
+
+   for(i=0;i<CODES;i++) unicode[i] = -1;
+   if ( !has_table )
+   {
+      for(g=0;(g<glyph_count) && (g<CODES);g++) unicode[g] = g;
+   }
+   else
+   {
+      /* One entry per glyph: characters, then (optional) sequences, then a terminator */
+      p = buf + header + size;
+      for(g=0;(g<glyph_count) && (p < buf + n);g++)
+      {
+         while ( p < buf + n )
+         {
+            if ( psf2 )
+            {
+               if ( *p == 0xFF ) { p++; break; }
+               if ( *p == 0xFE ) { while ( (p < buf + n) && (*p != 0xFF) ) p++; continue; }
+               len = decode_utf8( p, buf + n - p, &c );
+               if ( !len ) { p++; continue; }
+               p += len;
+            }
+            else
+            {
+               if ( p + 1 >= buf + n ) { p = buf + n; break; }
+               c = p[0] | (p[1] << 8);
+               p += 2;
+               if ( c == 0xFFFF ) break;
+               if ( c == 0xFFFE ) { while ( (p + 1 < buf + n) && ((p[0] | (p[1] << 8)) != 0xFFFF) ) p += 2; continue; }
+            }
+            if ( (c < CODES) && (unicode[c] < 0) ) unicode[c] = g;
+         }
+      }
+   }
+   free( buf );
+   return 0;
+}
+
+static void use( unsigned int c )
+{
+   /* Control characters are never drawn */
+   if ( (c < 0x20) || (c >= CODES) ) return;
+   used[c] = 1;
+}
+
+/* Characters of text. Single bytes are Latin-1, unless -u is given */
+static void use_text( const unsigned char* p, size_t n )
+{
+   unsigned int c;
+   int len;
+
+   while ( n )
+   {
+      len = 1;
+      c = *p;
+      if ( utf8 && (c >= 0x80) )
+      {
+         len = decode_utf8( p, n, &c );
+         if ( !len )
+         {
+            c = *p;
+            len = 1;
+         }
+      }
+      use( c );
+      p += len;
+      n -= len;
+   }
+}
+
+/* Collects the characters of all string and character literals */
+static void scan_c( const unsigned char* p, size_t n )
+{
+   const unsigned char* end = p + n;
+   unsigned char lit[4096];
+   size_t len;
+   int q,d,i;
+
+   while ( p < end )
+   {
+      if ( (p + 1 < end) && (p[0] == '/') && (p[1] == '/') )
+      {
+         while ( (p < end) && (*p != '\n') ) p++;
+      }
+      else if ( (p + 1 < end) && (p[0] == '/') && (p[1] == '*') )
+      {
+         p += 2;
+         while ( (p + 1 < end) && !((p[0] == '*') && (p[1] == '/')) ) p++;
+         p += 2;
+      }
+      else if ( *p == '#' )
+      {
+         /* Skip preprocessor lines, e.g. the file names of #include */
+         while ( (p < end) && (*p != '\n') )
+         {
+            if ( (*p == '\\') && (p + 1 < end) ) p++;
+            p++;
+         }
+      }
+      else if ( (*p == '"') || (*p == '\'') )
+      {
+         q = *p++;
+         len = 0;
+         while ( (p < end) && (*p != q) && (*p != '\n') )
+         {
+            d = *p++;
+            if ( (d == '\\') && (p < end) )
+            {
+               d = *p++;
+               switch ( d )
+               {
+                  case 'n': d = '\n'; break;
+                  case 't': d = '\t'; break;
+                  case 'r': d = '\r'; break;
+                  case 'a': case 'b': case 'f': case 'v': d = 0; break;
+                  case 'x':
+                     d = 0;
+                     while ( (p < end) && isxdigit( *p ) )
+                     {
+                        d = d*16 + ( isdigit( *p ) ? *p - '0' : (tolower( *p ) - 'a' + 10) );
+                        p++;
+                     }
+                     break;
+                  default:
+                     if ( (d >= '0') && (d <= '7') )
+                     {
+                        d -= '0';
+                        for(i=0;(i<2) && (p < end) && (*p >= '0') && (*p <= '7');i++) d = d*8 + *p++ - '0';
+                     }
+               }
+            }
+            if ( len < sizeof(lit) ) lit[len++] = (unsigned char)d;
+         }
+         p++;
+         use_text( lit, len );
+      }
+      else p++;
+   }
+}
+
+static int scan_source( const char* file )
+{
+   FILE* f;
+   unsigned char* buf;
+   const char* ext;
+   size_t n;
+
+   f = fopen( file, "rb" );
+   if ( f == NULL )
+   {
+      perror( file );
+      return -1;
+   }
+   fseek( f, 0, SEEK_END );
+   n = ftell( f );
+   fseek( f, 0, SEEK_SET );
+   buf = malloc( n + 1 );
+   if ( (buf == NULL) || (fread( buf, 1, n, f ) != n) )
+   {
+      perror( file );
+      return -1;
+   }
+   fclose( f );
+
+   ext = strrchr( file, '.' );
+   if ( (ext != NULL) && (!strcmp( ext, ".c" ) || !strcmp( ext, ".h" ) || !strcmp( ext, ".cpp" )) ) scan_c( buf, n );
+   else use_text( buf, n );
+   free( buf );
+   return 0;
+}
+
+/* Selects the glyphs of all used characters, returns the number of ranges */
+static int select_glyphs( void )
+{
+   unsigned int c;
+   int ranges,missing;
+
+   count = 0;
+   ranges = 0;
+   missing = 0;
+   for(c=0;c<CODES;c++)
+   {
+      if ( !used[c] ) continue;
+      if ( unicode[c] < 0 )
+      {
+         if ( missing++ < 16 ) fprintf( stderr, "no glyph for U+%04X\n", c );
+         continue;
+      }
+      if ( !count || (codes[count-1] != c - 1) ) ranges++;
+      glyphs[count] = unicode[c];
+      codes[count] = c;
+      count++;
+   }
+   if ( missing ) fprintf( stderr, "%d characters without glyph\n", missing );
+   return ranges;
+}
+
+/* Finds the ink boxes of the glyphs, without -b they cover the whole cell */
+static void find_boxes( void )
+{
+   int i,g,x,y,x0,y0,x1,y1;
+
+   for(i=0;i<count;i++)
+   {
+      g = glyphs[i];
+      x0 = width;
+      y0 = height;
+      x1 = -1;
+      y1 = -1;
+      for(y=0;y<height;y++)
+      {
+         for(x=0;x<width;x++)
+         {
+            if ( !pixel( g, x, y ) ) continue;
+            if ( x < x0 ) x0 = x;
+            if ( x > x1 ) x1 = x;
+            if ( y < y0 ) y0 = y;
+            if ( y > y1 ) y1 = y;
+         }
+      }
+      if ( !trim )
+      {
+         x0 = 0;
+         y0 = 0;
+         x1 = width - 1;
+         y1 = height - 1;
+      }
+      else if ( x1 < 0 )
+      {
+         /* Empty glyph */
+         x0 = y0 = 0;
+         x1 = y1 = -1;
+      }
+      box[i][0] = x0;
+      box[i][1] = y0;
+      box[i][2] = x1 - x0 + 1;
+      box[i][3] = y1 - y0 + 1;
+   }
+}
+
+static void encode_raw( void )
+{
+   size_t size;
+   int i,g,x,y,b;
+
+   size = (size_t)height * bytes_per_row;
+   for(i=0;i<count;i++)
+   {
+      g = glyphs[i];
+      offsets[i] = out_len;
+      if ( !trim )
+      {
+         for(x=0;x<(int)size;x++) emit( font[g * size + x] );
+         continue;
+      }
+      /* LSB first, every row starts at a byte boundary */
+      for(y=box[i][1];y<box[i][1]+box[i][3];y++)
+      {
+         b = 0;
+         for(x=0;x<box[i][2];x++)
+         {
+            b |= pixel( g, box[i][0] + x, y ) << (x & 7);
+            if ( (x & 7) == 7 )
+            {
+               emit( b );
+               b = 0;
+            }
+         }
+         if ( box[i][2] & 7 ) emit( b );
+      }
+   }
+}
+
+static int nibble_pending = -1;
+
+static void emit_nibble( int v )
+{
+   if ( nibble_pending < 0 )
+   {
+      nibble_pending = v;
+   }
+   else
+   {
+      emit( (unsigned char)((nibble_pending << 4) | v) );
+      nibble_pending = -1;
+   }
+}
+
+static void flush_nibbles( void )
+{
+   if ( nibble_pending >= 0 ) emit_nibble( 0 );
+}
+
+static void emit_run( int run )
+{
+   while ( run >= 15 )
+   {
+      emit_nibble( 15 );
+      run -= 15;
+   }
+   emit_nibble( run );
+}
+
+static int rows_equal( int g, int x0, int w, int y1, int y2 )
+{
+   int x;
+
+   for(x=x0;x<x0+w;x++)
+   {
+      if ( pixel( g, x, y1 ) != pixel( g, x, y2 ) ) return 0;
+   }
+   return 1;
+}
+
+static void encode_rle( void )
+{
+   int i,g,x,y,v,run,rep,first,x0,x1,y1;
+
+   for(i=0;i<count;i++)
+   {
+      g = glyphs[i];
+      offsets[i] = out_len;
+      x0 = box[i][0];
+      x1 = x0 + box[i][2];
+      y1 = box[i][1] + box[i][3];
+      y = box[i][1];
+      while ( y < y1 )
+      {
+         rep = 0;
+         while ( (rep < 15) && (y + rep + 1 < y1) && rows_equal( g, x0, box[i][2], y, y + rep + 1 ) ) rep++;
+         emit_nibble( rep );
+
+         /* Runs alternate background/foreground, starting with background */
+         x = x0;
+         v = 0;
+         first = 1;
+         while ( x < x1 )
+         {
+            run = 0;
+            while ( (x < x1) && (pixel( g, x, y ) == v) )
+            {
+               run++;
+               x++;
+            }
+            /* A trailing background run is replaced by the end of row code */
+            if ( (x == x1) && !v && !first ) run = 0;
+            emit_run( run );
+            v ^= 1;
+            first = 0;
+         }
+         y += rep + 1;
+      }
+      flush_nibbles();
+   }
+}
+
+/* Scales every glyph down by 'scale', levels are the coverage of the blocks */
+static void encode_aa( int bpp )
+{
+   int g,x,y,i,j,w,h,n,v,levels,bits,acc;
+
+   w = (width + scale - 1) / scale;
+   h = (height + scale - 1) / scale;
+   levels = (1 << bpp) - 1;
+   for(g=0;g<count;g++)
+   {
+      offsets[g] = out_len;
+      for(y=0;y<h;y++)
+      {
+         acc = 0;
+         bits = 0;
+         for(x=0;x<w;x++)
+         {
+            n = 0;
+            for(j=y*scale;(j<(y+1)*scale) && (j<height);j++)
+            {
+               for(i=x*scale;(i<(x+1)*scale) && (i<width);i++) n += pixel( glyphs[g], i, j );
+            }
+            v = (n * levels + (scale * scale) / 2) / (scale * scale);
+
+            /* High bits first, every row starts at a byte boundary */
+            acc = (acc << bpp) | v;
+            bits += bpp;
+            if ( bits == 8 )
+            {
+               emit( acc );
+               acc = 0;
+               bits = 0;
+            }
+         }
+         if ( bits ) emit( acc << (8 - bits) );
+      }
+   }
+   width = w;
+   height = h;
+}
+
+static void write_font( FILE* f, const char* src, const char* name, const char* mode, const char* type, int ranges )
+{
+   char data[64];
+   size_t i;
+   int g,r,has_offsets;
+
+   has_offsets = !strcmp( type, "FONT_TYPE_1BPP_RLE" ) || trim;
+   /* The trimmed tables get their own names, so both can be linked */
+   snprintf( data, sizeof(data), "%s_%s%s", src, mode, trim ? "_bb" : "" );
+   for(i=0;data[i];i++) if ( data[i] == '-' ) data[i] = '_';
+
+   fprintf( f, "/* Generated by ugui_fontconv from %s (%s%s) */\n", src, mode, trim ? ", -b" : "" );
+   fprintf( f, "#include \"ugui.h\"\n\n" );
+   fprintf( f, "__UG_FONT_DATA unsigned char %s[%lu]={\n", data, (unsigned long)out_len );
+   for(g=0;g<count;g++)
+   {
+      size_t end = ( g == count-1 ) ? out_len : offsets[g+1];
+      fprintf( f, "/* 0x%02X */ ", codes[g] );
+      for(i=offsets[g];i<end;i++) fprintf( f, "0x%02X,", out[i] );
+      fprintf( f, "\n" );
+   }
+   fprintf( f, "};\n\n" );
+
+   if ( has_offsets )
+   {
+      /* One more offset than glyphs, the last one ends the data */
+      fprintf( f, "__UG_FONT_DATA UG_U32 %s_offsets[%d]={", data, count+1 );
+      for(g=0;g<count;g++)
+      {
+         if ( !(g % 8) ) fprintf( f, "\n   " );
+         fprintf( f, "%lu,", offsets[g] );
+      }
+      fprintf( f, "%s%lu,", ( count % 8 ) ? "" : "\n   ", (unsigned long)out_len );
+      fprintf( f, "\n};\n\n" );
+   }
+
+   if ( ranges )
+   {
+      fprintf( f, "__UG_FONT_DATA UG_FONT_RANGE %s_ranges[%d]={\n", data, ranges );
+      for(g=0;g<count;g=r)
+      {
+         for(r=g+1;(r<count) && (codes[r] == codes[r-1] + 1);r++);
+         fprintf( f, "   {0x%04X,0x%04X,%d},\n", codes[g], codes[r-1], g );
+      }
+      fprintf( f, "};\n\n" );
+   }
+
+   if ( trim )
+   {
+      fprintf( f, "__UG_FONT_DATA UG_FONT_BBOX %s_bboxes[%d]={", data, count );
+      for(g=0;g<count;g++)
+      {
+         if ( !(g % 8) ) fprintf( f, "\n   " );
+         fprintf( f, "{%d,%d,%d,%d},", box[g][0], box[g][1], box[g][2], box[g][3] );
+      }
+      fprintf( f, "\n};\n\n" );
+   }
+
+   fprintf( f, "const UG_FONT %s = {(unsigned char*)%s,%s,%d,%d,0x%04X,0x%04X,NULL,", name, data, type, width, height,
+            codes[0], codes[count-1] );
+   if ( has_offsets ) fprintf( f, "%s_offsets,", data );
+   else fprintf( f, "NULL," );
+   if ( ranges ) fprintf( f, "%s_ranges,%d,", data, ranges );
+   else fprintf( f, "NULL,0," );
+   if ( trim ) fprintf( f, "NULL,%s_bboxes,1", data );
+   else fprintf( f, "NULL,NULL,1" );
+   fprintf( f, "};\n" );
+}
+
+int main( int argc, char** argv )
+{
+   FILE* f;
+   const char* mode;
+   const char* type;
+   char src[48];
+   const char* s;
+   size_t raw;
+   int i,ranges;
+
+   while ( (argc > 1) && (argv[1][0] == '-') )
+   {
+      if ( !strcmp( argv[1], "-u" ) ) utf8 = 1;
+      else if ( !strcmp( argv[1], "-b" ) ) trim = 1;
+      else if ( !strcmp( argv[1], "-s" ) && (argc > 2) && (atoi( argv[2] ) > 0) )
+      {
+         scale = atoi( argv[2] );
+         argc--;
+         argv++;
+      }
+      else break;
+      argc--;
+      argv++;
+   }
+   if ( argc < 5 )
+   {
+      fprintf( stderr, "usage: %s [-u] [-b] [-s N] <1bpp|rle|subset|subset-rle|aa4|aa2> <ugui.c|font.psf> <font_WxH|psf> <NAME> [output.c [source ...]]\n", argv[0] );
+      return 1;
+   }
+   mode = argv[1];
+   if ( !strcmp( argv[3], "psf" ) )
+   {
+      if ( load_psf( argv[2] ) ) return 1;
+
+      /* Data arrays are named after the file */
+      s = strrchr( argv[2], '/' );
+      s = s ? s + 1 : argv[2];
+      for(i=0;s[i] && (s[i] != '.') && (i<(int)sizeof(src)-1);i++) src[i] = isalnum( (unsigned char)s[i] ) ? s[i] : '_';
+      src[i] = 0;
+   }
+   else
+   {
+      if ( load_font( argv[2], argv[3] ) ) return 1;
+      snprintf( src, sizeof(src), "%s", argv[3] );
+   }
+
+   raw = (size_t)GLYPHS * height * bytes_per_row;
+   ranges = 0;
+   if ( trim && (!strcmp( mode, "aa4" ) || !strcmp( mode, "aa2" )) )
+   {
+      fprintf( stderr, "-b only applies to the 1bpp modes\n" );
+      return 1;
+   }
+   if ( !strcmp( mode, "1bpp" ) || !strcmp( mode, "rle" ) || !strcmp( mode, "aa4" ) || !strcmp( mode, "aa2" ) )
+   {
+      /* All glyphs in their original order */
+      if ( argc > 6 )
+      {
+         fprintf( stderr, "mode %s takes no sources\n", mode );
+         return 1;
+      }
+      for(count=0;(count<GLYPHS) && (count<glyph_count);count++)
+      {
+         glyphs[count] = count;
+         codes[count] = count;
+      }
+      find_boxes();
+      if ( !strcmp( mode, "1bpp" ) )
+      {
+         encode_raw();
+         type = "FONT_TYPE_1BPP";
+      }
+      else if ( !strcmp( mode, "rle" ) )
+      {
+         encode_rle();
+         type = "FONT_TYPE_1BPP_RLE";
+      }
+      else if ( !strcmp( mode, "aa4" ) )
+      {
+         encode_aa( 4 );
+         type = "FONT_TYPE_4BPP";
+      }
+      else
+      {
+         encode_aa( 2 );
+         type = "FONT_TYPE_2BPP";
+      }
+   }
+   else if ( !strcmp( mode, "subset" ) || !strcmp( mode, "subset-rle" ) )
+   {
+      if ( argc < 7 )
+      {
+         fprintf( stderr, "mode %s needs at least one source\n", mode );
+         return 1;
+      }
+      for(i=6;i<argc;i++)
+      {
+         if ( scan_source( argv[i] ) ) return 1;
+      }
+      ranges = select_glyphs();
+      if ( !count )
+      {
+         fprintf( stderr, "no characters found\n" );
+         return 1;
+      }
+      find_boxes();
+      if ( !strcmp( mode, "subset" ) )
+      {
+         encode_raw();
+         type = "FONT_TYPE_1BPP";
+      }
+      else
+      {
+         encode_rle();
+         type = "FONT_TYPE_1BPP_RLE";
+      }
+   }
+   else
+   {
+      fprintf( stderr, "unknown mode '%s'\n", mode );
+      return 1;
+   }
+
+   f = ( argc >= 6 ) ? fopen( argv[5], "w" ) : stdout;
+   if ( f == NULL )
+   {
+      perror( argv[5] );
+      return 1;
+   }
+   write_font( f, src, argv[4], mode, type, ranges );
+   if ( f != stdout ) fclose( f );
+
+   fprintf( stderr, "%s: %lu bytes raw, %d glyphs in %lu bytes %s", src,
+            (unsigned long)raw, count, (unsigned long)out_len, mode );
+   if ( !strcmp( type, "FONT_TYPE_1BPP_RLE" ) || trim ) fprintf( stderr, " + %lu bytes offsets", (unsigned long)((count + 1) * 4) );
+   if ( ranges ) fprintf( stderr, " + %lu bytes ranges", (unsigned long)(ranges * 6) );
+   if ( trim ) fprintf( stderr, " + %lu bytes bboxes", (unsigned long)(count * 4) );
+   fprintf( stderr, "\n" );
+   free( font );
+   free( out );
+   return 0;
+}
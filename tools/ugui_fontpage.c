@@ -0,0 +1,135 @@
+/* -------------------------------------------------------------------------------- */
+/* -- µGUI paged font demo                                                       -- */
+/* -------------------------------------------------------------------------------- */
+// Host-side stand-in for a font in external memory. The glyph data of
+// FONT_32X53 is written to a file and read back through the read function of
+// a paged font, so every glyph passes the glyph cache. The rendered text is
+// compared against the memory-resident font, then the cache hit rate and the
+// read latency are reported.
+//
+// Build (from the repository root):
+//    cc -O2 -I. -Itools -DUSE_FONT_PAGING -DUSE_FONT_32X53 -o ugui_fontpage ugui.c tools/ugui_fontpage.c
+// Usage:  ugui_fontpage <font.bin> [passes]
+//
+// The cache size is set at build time, e.g. -DUG_FONT_CACHE_SLOTS=64.
+/* -------------------------------------------------------------------------------- */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "ugui.h"
+
+#define WIDTH  480
+#define HEIGHT 272
+
+static UG_COLOR fb[HEIGHT][WIDTH];
+static UG_COLOR ref[HEIGHT][WIDTH];
+static FILE* font_file;
+static unsigned long reads;
+static unsigned long read_bytes;
+static double read_ns;
+
+static double now_ns( void )
+{
+   struct timespec ts;
+
+   clock_gettime( CLOCK_MONOTONIC, &ts );
+   return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static void pset( UG_S16 x, UG_S16 y, UG_COLOR c )
+{
+   if ( (x >= 0) && (y >= 0) && (x < WIDTH) && (y < HEIGHT) ) fb[y][x] = c;
+}
+
+static UG_S8 font_read( const UG_FONT* font, UG_U32 offset, UG_U8* buf, UG_U16 len )
+{
+   double t;
+   size_t n;
+
+   (void)font;
+   t = now_ns();
+   if ( fseek( font_file, offset, SEEK_SET ) != 0 ) return UG_RESULT_FAIL;
+   n = fread( buf, 1, len, font_file );
+   read_ns += now_ns() - t;
+   reads++;
+   read_bytes += n;
+
+   if ( n != len ) return UG_RESULT_FAIL;
+   return UG_RESULT_OK;
+}
+
+static double render( const UG_FONT* font, int passes )
+{
+   static char* text[] = {
+      "The quick brown",
+      "fox jumps over",
+      "the lazy dog.",
+      "0123456789 ABC",
+      "Hello, world!"
+   };
+   double t;
+   int i,j;
+
+   UG_FontSelect( font );
+   t = now_ns();
+   for(i=0;i<passes;i++)
+   {
+      for(j=0;j<5;j++) UG_PutString( 0, j*54, text[j] );
+   }
+   return (now_ns() - t) / passes;
+}
+
+int main( int argc, char** argv )
+{
+   UG_GUI gui;
+   UG_FONT paged;
+   UG_U32 hits,misses;
+   double t_mem,t_paged;
+   size_t size;
+   int passes;
+
+   if ( argc < 2 )
+   {
+      fprintf( stderr, "usage: %s <font.bin> [passes]\n", argv[0] );
+      return 1;
+   }
+   passes = ( argc > 2 ) ? atoi( argv[2] ) : 100;
+   if ( passes < 1 ) passes = 1;
+
+   /* Write the glyph data of the built-in font */
+   size = (size_t)(FONT_32X53.end_char - FONT_32X53.start_char + 1) * FONT_32X53.char_height * ((FONT_32X53.char_width + 7) / 8);
+   font_file = fopen( argv[1], "wb" );
+   if ( (font_file == NULL) || (fwrite( FONT_32X53.p, 1, size, font_file ) != size) )
+   {
+      perror( argv[1] );
+      return 1;
+   }
+   fclose( font_file );
+   font_file = fopen( argv[1], "rb" );
+   if ( font_file == NULL )
+   {
+      perror( argv[1] );
+      return 1;
+   }
+
+   /* Same font, but the data is only reachable through font_read */
+   paged = FONT_32X53;
+   paged.read = font_read;
+
+   UG_Init( &gui, pset, WIDTH, HEIGHT );
+   t_mem = render( &FONT_32X53, passes );
+   memcpy( ref, fb, sizeof(fb) );
+   memset( fb, 0, sizeof(fb) );
+   t_paged = render( &paged, passes );
+   UG_FontCacheGetStats( &hits, &misses );
+   fclose( font_file );
+
+   printf( "output:          %s\n", memcmp( ref, fb, sizeof(fb) ) ? "DIFFERENT" : "identical" );
+   printf( "cache:           %d slots of %d bytes\n", UG_FONT_CACHE_SLOTS, UG_FONT_CACHE_SLOT_SIZE );
+   printf( "glyph lookups:   %lu (%lu hits, %lu misses, %.1f%% hit rate)\n", (unsigned long)(hits + misses),
+           (unsigned long)hits, (unsigned long)misses, hits + misses ? 100.0 * hits / (hits + misses) : 0.0 );
+   printf( "reads:           %lu, %lu bytes, %.2f us per read\n", reads, read_bytes, reads ? read_ns / reads / 1000.0 : 0.0 );
+   printf( "render per pass: %.1f us memory, %.1f us paged\n", t_mem / 1000.0, t_paged / 1000.0 );
+   return 0;
+}
@@ -0,0 +1,303 @@
+/* -------------------------------------------------------------------------------- */
+/* -- µGUI image converter                                                       -- */
+/* -------------------------------------------------------------------------------- */
+// Host-side tool which converts a binary PPM (P6) image into a C source file
+// containing the pixel data and a matching UG_BMP structure.
+//
+// Build:  cc -O2 -o ugui_imgconv ugui_imgconv.c
+// Usage:  ugui_imgconv <format> <name> <input.ppm> [output.c]
+//
+// Formats:
+//    rgb565   uncompressed, BMP_BPP_16 / BMP_RGB565
+//    rgb888   uncompressed, BMP_BPP_32 / BMP_RGB888
+//    rle565   BMP_COMP_RLE, BMP_BPP_16 / BMP_RGB565
+//    rle888   BMP_COMP_RLE, BMP_BPP_32 / BMP_RGB888
+//    qoi      BMP_COMP_QOI, BMP_BPP_32 / BMP_RGB888
+/* -------------------------------------------------------------------------------- */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct
+{
+   unsigned char r,g,b,a;
+} PIXEL;
+
+static unsigned char* out;
+static size_t out_len;
+static size_t out_size;
+
+static void emit( unsigned char b )
+{
+   if ( out_len == out_size )
+   {
+      out_size = out_size ? out_size*2 : 4096;
+      out = realloc( out, out_size );
+      if ( out == NULL )
+      {
+         fprintf( stderr, "out of memory\n" );
+         exit( 1 );
+      }
+   }
+   out[out_len++] = b;
+}
+
+static void emit_pixel( PIXEL p, int bpp )
+{
+   unsigned int c;
+
+   if ( bpp == 16 )
+   {
+      c = ((p.r & 0xF8) << 8) | ((p.g & 0xFC) << 3) | (p.b >> 3);
+      emit( c & 0xFF );
+      emit( c >> 8 );
+   }
+   else
+   {
+      emit( p.b );
+      emit( p.g );
+      emit( p.r );
+      emit( 0 );
+   }
+}
+
+static int same( PIXEL a, PIXEL b, int bpp )
+{
+   if ( bpp == 16 ) return ((a.r>>3) == (b.r>>3)) && ((a.g>>2) == (b.g>>2)) && ((a.b>>3) == (b.b>>3));
+   return (a.r == b.r) && (a.g == b.g) && (a.b == b.b);
+}
+
+static void encode_raw( const PIXEL* px, size_t n, int bpp )
+{
+   size_t i;
+   for(i=0;i<n;i++) emit_pixel( px[i], bpp );
+}
+
+static void encode_rle( const PIXEL* px, size_t n, int bpp )
+{
+   size_t i,j,run,lit;
+
+   i = 0;
+   while ( i < n )
+   {
+      /* Run of identical pixels? */
+      run = 1;
+      while ( (i+run < n) && (run < 128) && same(px[i+run], px[i], bpp) ) run++;
+      if ( run > 1 )
+      {
+         emit( 0x80 | (run-1) );
+         emit_pixel( px[i], bpp );
+         i += run;
+         continue;
+      }
+
+      /* Collect literals up to the next run */
+      lit = 1;
+      while ( (i+lit < n) && (lit < 128) )
+      {
+         if ( (i+lit+1 < n) && same(px[i+lit], px[i+lit+1], bpp) ) break;
+         lit++;
+      }
+      emit( lit-1 );
+      for(j=0;j<lit;j++) emit_pixel( px[i+j], bpp );
+      i += lit;
+   }
+}
+
+static void encode_qoi( const PIXEL* px, size_t n )
+{
+   PIXEL index[64];
+   PIXEL prev = {0,0,0,255};
+   size_t i;
+   int run,h;
+   signed char vr,vg,vb,vg_r,vg_b;
+
+   memset( index, 0, sizeof(index) );
+   run = 0;
+   for(i=0;i<n;i++)
+   {
+      PIXEL p = px[i];
+      p.a = 255;
+
+      if ( (p.r == prev.r) && (p.g == prev.g) && (p.b == prev.b) && (p.a == prev.a) )
+      {
+         run++;
+         if ( (run == 62) || (i == n-1) )
+         {
+            emit( 0xC0 | (run-1) );
+            run = 0;
+         }
+         continue;
+      }
+      if ( run )
+      {
+         emit( 0xC0 | (run-1) );
+         run = 0;
+      }
+
+      h = (p.r*3 + p.g*5 + p.b*7 + p.a*11) & 0x3F;
+      if ( (index[h].r == p.r) && (index[h].g == p.g) && (index[h].b == p.b) && (index[h].a == p.a) )
+      {
+         emit( h );
+      }
+      else
+      {
+         index[h] = p;
+         vr = p.r - prev.r;
+         vg = p.g - prev.g;
+         vb = p.b - prev.b;
+         vg_r = vr - vg;
+         vg_b = vb - vg;
+         if ( (vr > -3) && (vr < 2) && (vg > -3) && (vg < 2) && (vb > -3) && (vb < 2) )
+         {
+            emit( 0x40 | ((vr+2) << 4) | ((vg+2) << 2) | (vb+2) );
+         }
+         else if ( (vg_r > -9) && (vg_r < 8) && (vg > -33) && (vg < 32) && (vg_b > -9) && (vg_b < 8) )
+         {
+            emit( 0x80 | (vg+32) );
+            emit( ((vg_r+8) << 4) | (vg_b+8) );
+         }
+         else
+         {
+            emit( 0xFE );
+            emit( p.r );
+            emit( p.g );
+            emit( p.b );
+         }
+      }
+      prev = p;
+   }
+}
+
+static int read_token( FILE* f )
+{
+   int c,v;
+
+   /* Skip white space and comments */
+   do
+   {
+      c = fgetc( f );
+      if ( c == '#' ) while ( (c != '\n') && (c != EOF) ) c = fgetc( f );
+   } while ( (c == ' ') || (c == '\t') || (c == '\r') || (c == '\n') );
+
+   v = -1;
+   while ( (c >= '0') && (c <= '9') )
+   {
+      v = ( v < 0 ) ? (c - '0') : (v*10 + c - '0');
+      c = fgetc( f );
+   }
+   return v;
+}
+
+int main( int argc, char** argv )
+{
+   FILE* f;
+   PIXEL* px;
+   size_t i,n;
+   int w,h,maxval,bpp,comp;
+   const char* fmt;
+   const char* name;
+
+   if ( (argc < 4) || (argc > 5) )
+   {
+      fprintf( stderr, "usage: %s <rgb565|rgb888|rle565|rle888|qoi> <name> <input.ppm> [output.c]\n", argv[0] );
+      return 1;
+   }
+   fmt = argv[1];
+   name = argv[2];
+
+   if ( !strcmp(fmt,"rgb565") ) { bpp = 16; comp = 0; }
+   else if ( !strcmp(fmt,"rgb888") ) { bpp = 32; comp = 0; }
+   else if ( !strcmp(fmt,"rle565") ) { bpp = 16; comp = 1; }
+   else if ( !strcmp(fmt,"rle888") ) { bpp = 32; comp = 1; }
+   else if ( !strcmp(fmt,"qoi") ) { bpp = 32; comp = 2; }
+   else
+   {
+      fprintf( stderr, "unknown format '%s'\n", fmt );
+      return 1;
+   }
+
+   f = fopen( argv[3], "rb" );
+   if ( f == NULL )
+   {
+      perror( argv[3] );
+      return 1;
+   }
+   if ( (fgetc(f) != 'P') || (fgetc(f) != '6') )
+   {
+      fprintf( stderr, "%s: not a binary PPM (P6) file\n", argv[3] );
+      return 1;
+   }
+   w = read_token( f );
+   h = read_token( f );
+   maxval = read_token( f );
+   if ( (w <= 0) || (h <= 0) || (w > 0xFFFF) || (h > 0xFFFF) || (maxval != 255) )
+   {
+      fprintf( stderr, "%s: unsupported PPM header\n", argv[3] );
+      return 1;
+   }
+
+   n = (size_t)w * h;
+   px = malloc( n * sizeof(PIXEL) );
+   if ( px == NULL ) return 1;
+   for(i=0;i<n;i++)
+   {
+      unsigned char rgb[3];
+      if ( fread( rgb, 1, 3, f ) != 3 )
+      {
+         fprintf( stderr, "%s: truncated image data\n", argv[3] );
+         return 1;
+      }
+      px[i].r = rgb[0];
+      px[i].g = rgb[1];
+      px[i].b = rgb[2];
+      px[i].a = 255;
+   }
+   fclose( f );
+
+   if ( comp == 0 ) encode_raw( px, n, bpp );
+   else if ( comp == 1 ) encode_rle( px, n, bpp );
+   else encode_qoi( px, n );
+
+   f = ( argc == 5 ) ? fopen( argv[4], "w" ) : stdout;
+   if ( f == NULL )
+   {
+      perror( argv[4] );
+      return 1;
+   }
+
+   fprintf( f, "/* Generated by ugui_imgconv from %s (%dx%d, %s) */\n", argv[3], w, h, fmt );
+   fprintf( f, "#include \"ugui.h\"\n\n" );
+   if ( comp == 0 )
+   {
+      /* Uncompressed data has to be aligned to its pixel size */
+      fprintf( f, "const %s %s_data[] =\n{", (bpp == 16) ? "UG_U16" : "UG_U32", name );
+      for(i=0;i<out_len;i+=bpp/8)
+      {
+         if ( !(i % (bpp == 16 ? 24 : 32)) ) fprintf( f, "\n   " );
+         if ( bpp == 16 ) fprintf( f, "0x%04X,", out[i] | (out[i+1] << 8) );
+         else fprintf( f, "0x%06X,", out[i] | (out[i+1] << 8) | (out[i+2] << 16) );
+      }
+   }
+   else
+   {
+      fprintf( f, "const UG_U8 %s_data[] =\n{", name );
+      for(i=0;i<out_len;i++)
+      {
+         if ( !(i % 16) ) fprintf( f, "\n   " );
+         fprintf( f, "0x%02X,", out[i] );
+      }
+   }
+   fprintf( f, "\n};\n\n" );
+   fprintf( f, "UG_BMP %s = {(void*)%s_data,%d,%d,%s,%s,NULL,%s};\n", name, name, w, h,
+            (bpp == 16) ? "BMP_BPP_16" : "BMP_BPP_32",
+            (bpp == 16) ? "BMP_RGB565" : "BMP_RGB888",
+            (comp == 0) ? "BMP_COMP_NONE" : (comp == 1) ? "BMP_COMP_RLE" : "BMP_COMP_QOI" );
+   if ( f != stdout ) fclose( f );
+
+   fprintf( stderr, "%s: %dx%d, %lu bytes raw, %lu bytes %s\n", name, w, h,
+            (unsigned long)(n * (bpp/8)), (unsigned long)out_len, fmt );
+   free( px );
+   free( out );
+   return 0;
+}
@@ -0,0 +1,339 @@
+/* -------------------------------------------------------------------------------- */
+/* -- µGUI asset pack builder                                                    -- */
+/* -------------------------------------------------------------------------------- */
+// Host-side tool which collects fonts and bitmaps into one asset pack. The
+// pack is used in place by UG_PackOpen() (see "ASSET PACK" in ugui.h), e.g.
+// memory mapped from a file or linked into flash.
+//
+// Build:  cc -O2 -o ugui_pack ugui_pack.c
+// Usage:  ugui_pack <output.pack> <asset> [<asset> ...]
+//
+// Assets:
+//    font:<name>:<ugui.c>:<font_WxH>         1bpp font table from ugui.c
+//    bmp:<name>:<rgb565|rgb888>:<image.ppm>  uncompressed bitmap
+//
+// Names are at most 16 characters long.
+/* -------------------------------------------------------------------------------- */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_ASSETS      256
+#define NAME_LENGTH     16
+#define GLYPHS          256
+
+#define PACK_MAGIC      0x4B504755
+#define PACK_VERSION    1
+#define HEADER_SIZE     16
+#define ENTRY_SIZE      32
+#define FONT_SIZE       28
+#define BMP_SIZE        16
+
+static unsigned char* out;
+static size_t out_len;
+static size_t out_size;
+
+static void reserve( size_t n )
+{
+   while ( out_len + n > out_size )
+   {
+      out_size = out_size ? out_size*2 : 4096;
+      out = realloc( out, out_size );
+      if ( out == NULL )
+      {
+         fprintf( stderr, "out of memory\n" );
+         exit( 1 );
+      }
+   }
+}
+
+static void emit( unsigned char b )
+{
+   reserve( 1 );
+   out[out_len++] = b;
+}
+
+static void emit16( unsigned int v )
+{
+   emit( v & 0xFF );
+   emit( (v >> 8) & 0xFF );
+}
+
+static void align4( void )
+{
+   while ( out_len & 3 ) emit( 0 );
+}
+
+/* Values are patched in after the data they point to has been written */
+static void put16( size_t pos, unsigned int v )
+{
+   out[pos] = v & 0xFF;
+   out[pos+1] = (v >> 8) & 0xFF;
+}
+
+static void put32( size_t pos, unsigned long v )
+{
+   put16( pos, v & 0xFFFF );
+   put16( pos+2, (v >> 16) & 0xFFFF );
+}
+
+static int load_font( const char* file, const char* name, int* width, int* height )
+{
+   FILE* f;
+   char line[4096];
+   char key[64];
+   char* s;
+   size_t n,size,start;
+   int found;
+
+   if ( sscanf( name, "font_%dx%d", width, height ) != 2 )
+   {
+      fprintf( stderr, "%s: font name must look like font_WxH\n", name );
+      return -1;
+   }
+   size = (size_t)GLYPHS * *height * ((*width + 7) / 8);
+
+   f = fopen( file, "r" );
+   if ( f == NULL )
+   {
+      perror( file );
+      return -1;
+   }
+
+   snprintf( key, sizeof(key), "unsigned char %s[", name );
+   found = 0;
+   start = out_len;
+   while ( fgets( line, sizeof(line), f ) != NULL )
+   {
+      if ( !found )
+      {
+         if ( strstr( line, key ) != NULL ) found = 1;
+         continue;
+      }
+      if ( strstr( line, "};" ) == line ) break;
+
+      /* Strip trailing comments, they contain the character codes */
+      s = strstr( line, "//" );
+      if ( s != NULL ) *s = 0;
+      s = line;
+      while ( (s = strstr( s, "0x" )) != NULL )
+      {
+         emit( (unsigned char)strtoul( s, NULL, 16 ) );
+         s += 2;
+      }
+   }
+   fclose( f );
+
+   if ( !found )
+   {
+      fprintf( stderr, "%s: font table %s not found\n", file, name );
+      return -1;
+   }
+   n = out_len - start;
+   if ( n != size )
+   {
+      fprintf( stderr, "%s: expected %lu bytes, found %lu\n", name, (unsigned long)size, (unsigned long)n );
+      return -1;
+   }
+   return 0;
+}
+
+static int read_token( FILE* f )
+{
+   int c,v;
+
+   /* Skip whitespace and comments */
+   do
+   {
+      c = fgetc( f );
+      if ( c == '#' ) while ( (c != '\n') && (c != EOF) ) c = fgetc( f );
+   } while ( (c == ' ') || (c == '\t') || (c == '\r') || (c == '\n') );
+
+   v = 0;
+   while ( (c >= '0') && (c <= '9') )
+   {
+      v = v*10 + (c - '0');
+      c = fgetc( f );
+   }
+   return v;
+}
+
+static int load_ppm( const char* file, int bpp, int* width, int* height )
+{
+   FILE* f;
+   unsigned char rgb[3];
+   unsigned int c;
+   size_t i,n;
+   int maxval;
+
+   f = fopen( file, "rb" );
+   if ( f == NULL )
+   {
+      perror( file );
+      return -1;
+   }
+   if ( (fgetc(f) != 'P') || (fgetc(f) != '6') )
+   {
+      fprintf( stderr, "%s: not a binary PPM (P6) file\n", file );
+      fclose( f );
+      return -1;
+   }
+   *width = read_token( f );
+   *height = read_token( f );
+   maxval = read_token( f );
+   if ( (*width <= 0) || (*height <= 0) || (*width > 0xFFFF) || (*height > 0xFFFF) || (maxval != 255) )
+   {
+      fprintf( stderr, "%s: unsupported PPM header\n", file );
+      fclose( f );
+      return -1;
+   }
+
+   n = (size_t)*width * *height;
+   for(i=0;i<n;i++)
+   {
+      if ( fread( rgb, 1, 3, f ) != 3 )
+      {
+         fprintf( stderr, "%s: truncated image data\n", file );
+         fclose( f );
+         return -1;
+      }
+      if ( bpp == 16 )
+      {
+         c = ((rgb[0] & 0xF8) << 8) | ((rgb[1] & 0xFC) << 3) | (rgb[2] >> 3);
+         emit16( c );
+      }
+      else
+      {
+         emit( rgb[2] );
+         emit( rgb[1] );
+         emit( rgb[0] );
+         emit( 0 );
+      }
+   }
+   fclose( f );
+   return 0;
+}
+
+/* Writes the record and data of one asset, returns its type or 0 on error */
+static int add_asset( char* spec, char* name )
+{
+   char* type;
+   char* arg1;
+   char* arg2;
+   size_t rec;
+   int w,h,bpp;
+
+   type = strtok( spec, ":" );
+   arg1 = strtok( NULL, ":" );
+   if ( arg1 != NULL ) strncpy( name, arg1, NAME_LENGTH );
+   arg1 = strtok( NULL, ":" );
+   arg2 = strtok( NULL, "" );
+   if ( (type == NULL) || (arg1 == NULL) || (arg2 == NULL) )
+   {
+      fprintf( stderr, "asset must look like <type>:<name>:<arg>:<arg>\n" );
+      return 0;
+   }
+
+   rec = out_len;
+   if ( !strcmp( type, "font" ) )
+   {
+      /* UG_PACK_FONT */
+      reserve( FONT_SIZE );
+      memset( &out[rec], 0, FONT_SIZE );
+      out_len += FONT_SIZE;
+      if ( load_font( arg1, arg2, &w, &h ) ) return 0;
+      out[rec] = 0; /* FONT_TYPE_1BPP */
+      put16( rec+2, w );
+      put16( rec+4, h );
+      put16( rec+6, 0 );
+      put16( rec+8, GLYPHS-1 );
+      put32( rec+12, rec + FONT_SIZE );
+      align4();
+      return 1;
+   }
+   if ( !strcmp( type, "bmp" ) )
+   {
+      if ( !strcmp( arg1, "rgb565" ) ) bpp = 16;
+      else if ( !strcmp( arg1, "rgb888" ) ) bpp = 32;
+      else
+      {
+         fprintf( stderr, "unknown bitmap format '%s'\n", arg1 );
+         return 0;
+      }
+      /* UG_PACK_BMP */
+      reserve( BMP_SIZE );
+      memset( &out[rec], 0, BMP_SIZE );
+      out_len += BMP_SIZE;
+      if ( load_ppm( arg2, bpp, &w, &h ) ) return 0;
+      put16( rec, w );
+      put16( rec+2, h );
+      out[rec+4] = ( bpp == 16 ) ? (1<<4) : (1<<5); /* BMP_BPP_16 / BMP_BPP_32 */
+      out[rec+5] = ( bpp == 16 ) ? (1<<1) : (1<<0); /* BMP_RGB565 / BMP_RGB888 */
+      put32( rec+8, rec + BMP_SIZE );
+      align4();
+      return 2;
+   }
+   fprintf( stderr, "unknown asset type '%s'\n", type );
+   return 0;
+}
+
+int main( int argc, char** argv )
+{
+   FILE* f;
+   char name[NAME_LENGTH+1];
+   size_t entry,start;
+   int i,count,type;
+
+   if ( argc < 3 )
+   {
+      fprintf( stderr, "usage: %s <output.pack> <font|bmp>:<name>:<arg>:<arg> ...\n", argv[0] );
+      return 1;
+   }
+   count = argc - 2;
+   if ( count > MAX_ASSETS )
+   {
+      fprintf( stderr, "too many assets\n" );
+      return 1;
+   }
+
+   /* UG_PACK_HEADER and index, filled in as the assets are added */
+   reserve( HEADER_SIZE + count * ENTRY_SIZE );
+   memset( out, 0, HEADER_SIZE + count * ENTRY_SIZE );
+   out_len = HEADER_SIZE + count * ENTRY_SIZE;
+   put32( 0, PACK_MAGIC );
+   put16( 4, PACK_VERSION );
+   put16( 6, count );
+
+   for(i=0;i<count;i++)
+   {
+      memset( name, 0, sizeof(name) );
+      start = out_len;
+      type = add_asset( argv[i+2], name );
+      if ( !type ) return 1;
+
+      /* UG_PACK_ENTRY */
+      entry = HEADER_SIZE + i * ENTRY_SIZE;
+      memcpy( &out[entry], name, NAME_LENGTH );
+      put16( entry+16, type );
+      put32( entry+20, start );
+      put32( entry+24, out_len - start );
+      fprintf( stderr, "%-16s %s, %lu bytes\n", name, ( type == 1 ) ? "font" : "bmp", (unsigned long)(out_len - start) );
+   }
+   put32( 8, out_len );
+
+   f = fopen( argv[1], "wb" );
+   if ( f == NULL )
+   {
+      perror( argv[1] );
+      return 1;
+   }
+   if ( fwrite( out, 1, out_len, f ) != out_len )
+   {
+      perror( argv[1] );
+      return 1;
+   }
+   fclose( f );
+   fprintf( stderr, "%s: %d assets, %lu bytes\n", argv[1], count, (unsigned long)out_len );
+   free( out );
+   return 0;
+}
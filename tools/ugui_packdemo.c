@@ -0,0 +1,167 @@
+/* -------------------------------------------------------------------------------- */
+/* -- µGUI asset pack demo                                                       -- */
+/* -------------------------------------------------------------------------------- */
+// Memory maps an asset pack built by ugui_pack and uses its fonts and bitmaps
+// without copying them. The first font of the pack is compared against
+// FONT_8X12, which the pack is expected to contain (font:f8x12:ugui.c:font_8x12).
+// The first bitmap is drawn below the text; the framebuffer is written as PPM.
+//
+// Build (from the repository root):
+//    cc -O2 -I. -Itools -DUSE_ASSET_PACK -DUSE_FONT_8X12 -o ugui_packdemo ugui.c tools/ugui_packdemo.c
+// Usage:  ugui_packdemo <assets.pack> [output.ppm]
+/* -------------------------------------------------------------------------------- */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "ugui.h"
+
+#define WIDTH  320
+#define HEIGHT 240
+
+static UG_COLOR fb[HEIGHT][WIDTH];
+static UG_COLOR ref[HEIGHT][WIDTH];
+
+static double now_ns( void )
+{
+   struct timespec ts;
+
+   clock_gettime( CLOCK_MONOTONIC, &ts );
+   return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static void pset( UG_S16 x, UG_S16 y, UG_COLOR c )
+{
+   if ( (x >= 0) && (y >= 0) && (x < WIDTH) && (y < HEIGHT) ) fb[y][x] = c;
+}
+
+static void render( const UG_FONT* font )
+{
+   UG_FontSelect( font );
+   UG_PutString( 0, 0, "The quick brown fox" );
+   UG_PutString( 0, 12, "jumps over the lazy dog." );
+}
+
+static void write_ppm( const char* file )
+{
+   FILE* f;
+   UG_COLOR c;
+   int x,y;
+
+   f = fopen( file, "wb" );
+   if ( f == NULL )
+   {
+      perror( file );
+      return;
+   }
+   fprintf( f, "P6\n%d %d\n255\n", WIDTH, HEIGHT );
+   for(y=0;y<HEIGHT;y++)
+   {
+      for(x=0;x<WIDTH;x++)
+      {
+         c = fb[y][x];
+         #ifdef USE_COLOR_RGB565
+         fputc( (c >> 8) & 0xF8, f );
+         fputc( (c >> 3) & 0xFC, f );
+         fputc( (c << 3) & 0xF8, f );
+         #else
+         fputc( (c >> 16) & 0xFF, f );
+         fputc( (c >> 8) & 0xFF, f );
+         fputc( c & 0xFF, f );
+         #endif
+      }
+   }
+   fclose( f );
+}
+
+int main( int argc, char** argv )
+{
+   UG_GUI gui;
+   UG_PACK pack;
+   UG_FONT font;
+   UG_BMP bmp;
+   struct stat st;
+   const void* data;
+   const char* font_name;
+   const char* bmp_name;
+   char name[PACK_NAME_LENGTH+1];
+   double t;
+   int fd,i;
+
+   if ( argc < 2 )
+   {
+      fprintf( stderr, "usage: %s <assets.pack> [output.ppm]\n", argv[0] );
+      return 1;
+   }
+
+   fd = open( argv[1], O_RDONLY );
+   if ( (fd < 0) || (fstat( fd, &st ) != 0) )
+   {
+      perror( argv[1] );
+      return 1;
+   }
+   data = mmap( NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0 );
+   if ( data == MAP_FAILED )
+   {
+      perror( "mmap" );
+      return 1;
+   }
+   close( fd );
+
+   t = now_ns();
+   if ( UG_PackOpen( &pack, data, st.st_size ) != UG_RESULT_OK )
+   {
+      fprintf( stderr, "%s: not a valid asset pack\n", argv[1] );
+      return 1;
+   }
+   printf( "open:   %.2f us, %u assets\n", (now_ns() - t) / 1000.0, pack.count );
+
+   font_name = NULL;
+   bmp_name = NULL;
+   for(i=0;i<pack.count;i++)
+   {
+      memcpy( name, pack.index[i].name, PACK_NAME_LENGTH );
+      name[PACK_NAME_LENGTH] = 0;
+      printf( "  %-16s type %u, %lu bytes at %lu\n", name, pack.index[i].type,
+              (unsigned long)pack.index[i].size, (unsigned long)pack.index[i].offset );
+      if ( (pack.index[i].type == PACK_TYPE_FONT) && (font_name == NULL) ) font_name = pack.index[i].name;
+      if ( (pack.index[i].type == PACK_TYPE_BMP) && (bmp_name == NULL) ) bmp_name = pack.index[i].name;
+   }
+
+   UG_Init( &gui, pset, WIDTH, HEIGHT );
+   if ( font_name != NULL )
+   {
+      memcpy( name, font_name, PACK_NAME_LENGTH );
+      if ( UG_PackGetFont( &pack, name, &font ) != UG_RESULT_OK )
+      {
+         fprintf( stderr, "%s: font lookup failed\n", name );
+         return 1;
+      }
+      render( &FONT_8X12 );
+      memcpy( ref, fb, sizeof(fb) );
+      memset( fb, 0, sizeof(fb) );
+      render( &font );
+      printf( "font:   %dx%d, in place: %s, output %s FONT_8X12\n", font.char_width, font.char_height,
+              ( (const UG_U8*)font.p > (const UG_U8*)data ) && ( (const UG_U8*)font.p < (const UG_U8*)data + st.st_size ) ? "yes" : "no",
+              memcmp( ref, fb, sizeof(fb) ) ? "differs from" : "identical to" );
+   }
+   if ( bmp_name != NULL )
+   {
+      memcpy( name, bmp_name, PACK_NAME_LENGTH );
+      if ( UG_PackGetBMP( &pack, name, &bmp ) != UG_RESULT_OK )
+      {
+         fprintf( stderr, "%s: bitmap lookup failed\n", name );
+         return 1;
+      }
+      UG_DrawBMP( 0, 30, &bmp );
+      printf( "bitmap: %dx%d\n", bmp.width, bmp.height );
+   }
+   if ( argc > 2 ) write_ppm( argv[2] );
+
+   munmap( (void*)data, st.st_size );
+   return 0;
+}
@@ -54,14 +54,107 @@
  void _UG_WindowUpdate( UG_WINDOW* wnd );
  UG_RESULT _UG_WindowClear( UG_WINDOW* wnd );
  void _UG_TextboxUpdate(UG_WINDOW* wnd, UG_OBJECT* obj);
+ void _UG_TextboxGetText( UG_OBJECT* obj, UG_TEXT* txt );
+#ifdef USE_TEXTBOX_DIFF
+ void _UG_TextboxSaveText( UG_TEXTBOX* txb );
+ UG_U8 _UG_TextboxRedrawChanges( UG_TEXTBOX* txb, UG_TEXT* txt );
+#endif
+#ifdef USE_TEXTBOX_NUMBER
+ void _UG_TextboxUpdateNumber( UG_WINDOW* wnd, UG_OBJECT* obj );
+#endif
  void _UG_ButtonUpdate(UG_WINDOW* wnd, UG_OBJECT* obj);
  void _UG_CheckboxUpdate(UG_WINDOW* wnd, UG_OBJECT* obj);
  void _UG_ImageUpdate(UG_WINDOW* wnd, UG_OBJECT* obj);
- void _UG_PutChar( char chr, UG_S16 x, UG_S16 y, UG_COLOR fc, UG_COLOR bc, const UG_FONT* font);
+#ifdef USE_UPDATE_BUDGET
+ void _UG_UpdateObjectsBudget( UG_WINDOW* wnd );
+#endif
+#ifdef USE_BINDING
+ UG_RESULT _UG_BindingSetText( UG_BINDING* b );
+ UG_U8 _UG_BindingFormat( UG_BINDING* b, char* str );
+ UG_U8 _UG_BindingsChanged( void );
+ void _UG_UpdateBindings( void );
+#endif
+#ifdef USE_STATS
+ void _UG_StatsPset( UG_S16 x, UG_S16 y, UG_COLOR c );
+ void _UG_StatsClear( UG_STATS* stats );
+ UG_U32 _UG_StatsLap( void );
+#endif
+#ifdef USE_TRACE
+ void _UG_Trace( UG_U8 phase, UG_U8 kind, UG_U8 a, UG_U8 b );
+ void _UG_TraceNumber( void (*write)( const char* str ), UG_U32 v );
+#endif
+#ifdef USE_TIMER
+ void _UG_TimerInsert( UG_TIMER* t );
+ UG_S32 _UG_TweenValue( UG_TWEEN* tw, UG_U32 now );
+ void _UG_UpdateTimers( UG_U32 now );
+#endif
+ void _UG_PutChar( UG_U16 chr, UG_S16 x, UG_S16 y, UG_COLOR fc, UG_COLOR bc, const UG_FONT* font, UG_U8 transparent );
+ void _UG_PushGlyphRow( const UG_FONT* font, UG_U16 g, UG_U16 j, UG_COLOR fc, UG_COLOR bc, const UG_COLOR* lut, void(*push_pixel)(UG_COLOR) );
+ UG_U8 _UG_PutTextLine( UG_TEXT* txt, char* s, char* end, UG_U8 e, UG_S16 x, UG_S16 y );
+ void _UG_PutText( UG_TEXT* txt );
+#ifdef USE_LABEL_CACHE
+ void _UG_LabelCachePset( UG_S16 x, UG_S16 y, UG_COLOR c );
+ void _UG_LabelCacheBlit( UG_LABEL_CACHE_SLOT* s, UG_S16 x, UG_S16 y );
+ UG_U8 _UG_LabelCacheDraw( UG_TEXT* txt, UG_TEXT_LAYOUT* l );
+#endif
+ void _UG_PutGlyphRun( UG_S16 x, UG_S16 y, UG_U16 i, UG_U16 j, UG_U16 n, UG_U16 rows, UG_U8 s, UG_COLOR c );
+ void _UG_PutCharRLE( UG_S16 x, UG_S16 y, UG_U16 w, UG_U16 h, const UG_U8* p, UG_COLOR fc, UG_COLOR bc, UG_U8 transparent, UG_U8 s, void(*push_pixel)(UG_COLOR) );
+ void _UG_PutCharAA( UG_S16 x, UG_S16 y, UG_U16 w, UG_U16 h, const UG_U8* p, UG_U8 bpp, UG_U16 pitch, const UG_COLOR* lut, UG_U8 transparent, UG_U8 s, void(*push_pixel)(UG_COLOR) );
+ UG_COLOR _UG_BlendColor( UG_COLOR fc, UG_COLOR bc, UG_U8 alpha );
+ void _UG_BlendLevels( UG_COLOR* lut, UG_U16 levels, UG_COLOR fc, UG_COLOR bc );
+ const UG_COLOR* _UG_GetBlendLUT( UG_COLOR fc, UG_COLOR bc, UG_U16 levels, UG_COLOR* buf );
+ UG_U16 _UG_DecodeChar( char** str );
+ UG_U32 _UG_HashString( const char* str );
+ UG_U16 _UG_GetGlyph( const UG_FONT* font, UG_U16 chr );
+ UG_S16 _UG_GetCharWidth( const UG_FONT* font, UG_U16 chr );
+ UG_S16 _UG_GetCharHeight( const UG_FONT* font );
+ UG_U32 _UG_GetGlyphSize( const UG_FONT* font );
+ const UG_U8* _UG_GetGlyphData( const UG_FONT* font, UG_U16 g );
+#ifdef USE_FONT_PAGING
+ const UG_U8* _UG_FontCacheGet( const UG_FONT* font, UG_U32 offset, UG_U16 size );
+#endif
+ char* _UG_BreakLine( UG_TEXT* txt, char* str, UG_U8 last, UG_S16* width, char** next, UG_U8* ellipsis );
+ UG_S16 _UG_AlignLine( UG_TEXT* txt, UG_S16 width );
+ UG_U16 _UG_TextMaxLines( UG_TEXT* txt );
+ void _UG_LayoutText( UG_TEXT* txt, UG_TEXT_LAYOUT* l );
+ void _UG_ConvertRGB565ToRGB888( UG_U32* dst, const UG_U16* src, UG_U16 n );
+ void _UG_ConvertRGB888ToRGB565( UG_U16* dst, const UG_U32* src, UG_U16 n );
+ void _UG_ConvertByteSwap16( UG_U16* dst, const UG_U16* src, UG_U16 n );
+ void _UG_ConvertIndexed( UG_COLOR* dst, const UG_U8* src, UG_U16 n, UG_U8 bpp, const UG_COLOR* pal );
+ const UG_COLOR* _UG_ConvertColors( UG_COLOR* dst, const void* src, UG_U16 n, UG_U8 bpp, UG_U8 colors );
+ const UG_COLOR* _UG_ConvertIndexed8( UG_COLOR* dst, const UG_U8* src, UG_U16 n, const UG_BMP* bmp );
+ const UG_COLOR* _UG_ConvertPalette( UG_COLOR* lut, const UG_BMP* bmp );
+ UG_COLOR _UG_ReadBMPPixel( const UG_U8** p, const UG_BMP* bmp, const UG_COLOR* pal );
+ void _UG_DecodeBMP( UG_S16 xp, UG_S16 yp, const UG_BMP* bmp, const UG_COLOR* pal, void(*push_pixel)(UG_COLOR) );
+ void _UG_PushRow( UG_S16 x, UG_S16 y, const UG_COLOR* p, UG_U16 n, void(*push_pixel)(UG_COLOR) );
+#ifdef USE_ASSET_PACK
+ const UG_PACK_ENTRY* _UG_PackFind( const UG_PACK* pack, const char* name, UG_U16 type, UG_U32 record_size );
+ UG_U8 _UG_PackCheck( const UG_PACK_ENTRY* e, UG_U32 offset, UG_U32 count, UG_U32 size, UG_U32 align );
+ UG_U8 _UG_PackCheckRLE( const UG_U8* p, UG_U32 n, UG_U16 w, UG_U16 h );
+ UG_U8 _UG_PackCheckStream( const UG_U8* p, UG_U32 n, const UG_PACK_BMP* b );
+#endif
 
  /* Pointer to the gui */
 static UG_GUI* gui;
 
+/* Statistics (UG_GetStats), nothing is left of them without USE_STATS */
+#ifdef USE_STATS
+#define _UG_STAT_ADD(c,n)                             gui->stats.c += (n)
+#define _UG_STAT_TIME(c)                              gui->stats.c += _UG_StatsLap()
+#else
+#define _UG_STAT_ADD(c,n)
+#define _UG_STAT_TIME(c)
+#endif
+
+/* Trace events (UG_TraceDump), nothing is left of them without USE_TRACE */
+#ifdef USE_TRACE
+#define _UG_TRACE_BEGIN(k,a,b)                        _UG_Trace('B',k,a,b)
+#define _UG_TRACE_END(k,a,b)                          _UG_Trace('E',k,a,b)
+#else
+#define _UG_TRACE_BEGIN(k,a,b)
+#define _UG_TRACE_END(k,a,b)
+#endif
+
 #ifdef USE_FONT_4X6
 __UG_FONT_DATA unsigned char font_4x6[256][6]={
 {0x00,0x00,0x00,0x00,0x00,0x00}, // 0x00
@@ -4501,64 +4594,75 @@ __UG_FONT_DATA unsigned char font_32x53[256][212]={
 #endif
 
 #ifdef USE_FONT_4X6
-   const UG_FONT FONT_4X6 = {(unsigned char*)font_4x6,FONT_TYPE_1BPP,4,6,0,255,NULL};
+   const UG_FONT FONT_4X6 = {(unsigned char*)font_4x6,FONT_TYPE_1BPP,4,6,0,255,NULL,NULL,NULL,0,NULL,NULL,1};
 #endif
 #ifdef USE_FONT_5X8
-   const UG_FONT FONT_5X8 = {(unsigned char*)font_5x8,FONT_TYPE_1BPP,5,8,0,255,NULL};
+   const UG_FONT FONT_5X8 = {(unsigned char*)font_5x8,FONT_TYPE_1BPP,5,8,0,255,NULL,NULL,NULL,0,NULL,NULL,1};
 #endif
 #ifdef USE_FONT_5X12
-   const UG_FONT FONT_5X12 = {(unsigned char*)font_5x12,FONT_TYPE_1BPP,5,12,0,255,NULL};
+   const UG_FONT FONT_5X12 = {(unsigned char*)font_5x12,FONT_TYPE_1BPP,5,12,0,255,NULL,NULL,NULL,0,NULL,NULL,1};
 #endif
 #ifdef USE_FONT_6X8
-   const UG_FONT FONT_6X8 = {(unsigned char*)font_6x8,FONT_TYPE_1BPP,6,8,0,255,NULL};
+   const UG_FONT FONT_6X8 = {(unsigned char*)font_6x8,FONT_TYPE_1BPP,6,8,0,255,NULL,NULL,NULL,0,NULL,NULL,1};
 #endif
 #ifdef USE_FONT_6X10
-   const UG_FONT FONT_6X10 = {(unsigned char*)font_6x10,FONT_TYPE_1BPP,6,10,0,255,NULL};
+   const UG_FONT FONT_6X10 = {(unsigned char*)font_6x10,FONT_TYPE_1BPP,6,10,0,255,NULL,NULL,NULL,0,NULL,NULL,1};
 #endif
 #ifdef USE_FONT_7X12
-   const UG_FONT FONT_7X12 = {(unsigned char*)font_7x12,FONT_TYPE_1BPP,7,12,0,255,NULL};
+   const UG_FONT FONT_7X12 = {(unsigned char*)font_7x12,FONT_TYPE_1BPP,7,12,0,255,NULL,NULL,NULL,0,NULL,NULL,1};
 #endif
 #ifdef USE_FONT_8X8
-   const UG_FONT FONT_8X8 = {(unsigned char*)font_8x8,FONT_TYPE_1BPP,8,8,0,255,NULL};
+   const UG_FONT FONT_8X8 = {(unsigned char*)font_8x8,FONT_TYPE_1BPP,8,8,0,255,NULL,NULL,NULL,0,NULL,NULL,1};
 #endif
 #ifdef USE_FONT_8X12
-   const UG_FONT FONT_8X12 = {(unsigned char*)font_8x12,FONT_TYPE_1BPP,8,12,0,255,NULL};
+   const UG_FONT FONT_8X12 = {(unsigned char*)font_8x12,FONT_TYPE_1BPP,8,12,0,255,NULL,NULL,NULL,0,NULL,NULL,1};
 #endif
 #ifdef USE_FONT_8X12_CYRILLIC
-   const UG_FONT FONT_8X12 = {(unsigned char*)font_8x12,FONT_TYPE_1BPP,8,12,0,255,NULL};
+   const UG_FONT FONT_8X12 = {(unsigned char*)font_8x12,FONT_TYPE_1BPP,8,12,0,255,NULL,NULL,NULL,0,NULL,NULL,1};
 #endif
 #ifdef USE_FONT_8X14
-   const UG_FONT FONT_8X14 = {(unsigned char*)font_8x14,FONT_TYPE_1BPP,8,14,0,255,NULL};
+   const UG_FONT FONT_8X14 = {(unsigned char*)font_8x14,FONT_TYPE_1BPP,8,14,0,255,NULL,NULL,NULL,0,NULL,NULL,1};
 #endif
 #ifdef USE_FONT_10X16
-   const UG_FONT FONT_10X16 = {(unsigned char*)font_10x16,FONT_TYPE_1BPP,10,16,0,255,NULL};
+   const UG_FONT FONT_10X16 = {(unsigned char*)font_10x16,FONT_TYPE_1BPP,10,16,0,255,NULL,NULL,NULL,0,NULL,NULL,1};
 #endif
 #ifdef USE_FONT_12X16
-   const UG_FONT FONT_12X16 = {(unsigned char*)font_12x16,FONT_TYPE_1BPP,12,16,0,255,NULL};
+   const UG_FONT FONT_12X16 = {(unsigned char*)font_12x16,FONT_TYPE_1BPP,12,16,0,255,NULL,NULL,NULL,0,NULL,NULL,1};
 #endif
 #ifdef USE_FONT_12X20
-   const UG_FONT FONT_12X20 = {(unsigned char*)font_12x20,FONT_TYPE_1BPP,12,20,0,255,NULL};
+   const UG_FONT FONT_12X20 = {(unsigned char*)font_12x20,FONT_TYPE_1BPP,12,20,0,255,NULL,NULL,NULL,0,NULL,NULL,1};
 #endif
 #ifdef USE_FONT_16X26
-   const UG_FONT FONT_16X26 = {(unsigned char*)font_16x26,FONT_TYPE_1BPP,16,26,0,255,NULL};
+   const UG_FONT FONT_16X26 = {(unsigned char*)font_16x26,FONT_TYPE_1BPP,16,26,0,255,NULL,NULL,NULL,0,NULL,NULL,1};
 #endif
 #ifdef USE_FONT_22X36
-   const UG_FONT FONT_22X36 = {(unsigned char*)font_22x36,FONT_TYPE_1BPP,22,36,0,255,NULL};
+   const UG_FONT FONT_22X36 = {(unsigned char*)font_22x36,FONT_TYPE_1BPP,22,36,0,255,NULL,NULL,NULL,0,NULL,NULL,1};
 #endif
 #ifdef USE_FONT_24X40
-   const UG_FONT FONT_24X40 = {(unsigned char*)font_24x40,FONT_TYPE_1BPP,24,40,0,255,NULL};
+   const UG_FONT FONT_24X40 = {(unsigned char*)font_24x40,FONT_TYPE_1BPP,24,40,0,255,NULL,NULL,NULL,0,NULL,NULL,1};
 #endif
 #ifdef USE_FONT_32X53
-   const UG_FONT FONT_32X53 = {(unsigned char*)font_32x53,FONT_TYPE_1BPP,32,53,0,255,NULL};
+   const UG_FONT FONT_32X53 = {(unsigned char*)font_32x53,FONT_TYPE_1BPP,32,53,0,255,NULL,NULL,NULL,0,NULL,NULL,1};
 #endif
 
 
 
 UG_S16 UG_Init( UG_GUI* g, void (*p)(UG_S16,UG_S16,UG_COLOR), UG_S16 x, UG_S16 y )
 {
-   UG_U8 i;
+   UG_U16 i;
 
    g->pset = (void(*)(UG_S16,UG_S16,UG_COLOR))p;
+#ifdef USE_STATS
+   /* Every pixel is counted on its way to the display */
+   g->stats_pset = g->pset;
+   g->pset = _UG_StatsPset;
+   g->stats_lap = 0;
+   _UG_StatsClear( &g->stats );
+#endif
+#ifdef USE_TRACE
+   g->trace_head = 0;
+   g->trace_count = 0;
+#endif
    g->x_dim = x;
    g->y_dim = y;
    g->console.x_start = 4;
@@ -4569,12 +4673,62 @@ UG_S16 UG_Init( UG_GUI* g, void (*p)(UG_S16,UG_S16,UG_COLOR), UG_S16 x, UG_S16 y
    g->console.y_pos = g->console.y_end;
    g->char_h_space = 1;
    g->char_v_space = 1;
+   g->transparent_font = 0;
+   g->touch.state = TOUCH_STATE_RELEASED;
+   g->touch.xp = -1;
+   g->touch.yp = -1;
+   g->touch.pending = 0;
    g->font.p = NULL;
    g->font.char_height = 0;
    g->font.char_width = 0;
    g->font.start_char = 0;
    g->font.end_char = 0;
    g->font.widths = NULL;
+   g->font.offsets = NULL;
+   g->font.ranges = NULL;
+   g->font.range_count = 0;
+   g->font.read = NULL;
+   g->font.bboxes = NULL;
+   g->font.scale = 1;
+   g->last_ranges = NULL;
+   g->last_range = 0;
+#ifdef USE_FONT_PAGING
+   for(i=0;i<UG_FONT_CACHE_SLOTS;i++)
+   {
+      g->font_cache[i].p = NULL;
+      g->font_cache[i].stamp = 0;
+   }
+   g->font_cache_clock = 0;
+   g->font_cache_hits = 0;
+   g->font_cache_misses = 0;
+#endif
+#ifdef USE_BLEND_CACHE
+   for(i=0;i<UG_BLEND_CACHE_SLOTS;i++) g->blend_cache[i].stamp = 0;
+   g->blend_cache_clock = 0;
+   g->blend_cache_hits = 0;
+   g->blend_cache_misses = 0;
+#endif
+#ifdef USE_BINDING
+   g->bindings = NULL;
+#endif
+#ifdef USE_CLOCK
+   g->clock = NULL;
+   g->update_start = 0;
+#endif
+#ifdef USE_UPDATE_BUDGET
+   g->update_budget = 0;
+#endif
+#ifdef USE_TIMER
+   g->timers = NULL;
+   g->tweens = NULL;
+#endif
+#ifdef USE_LABEL_CACHE
+   for(i=0;i<UG_LABEL_CACHE_SLOTS;i++) g->label_cache[i].stamp = 0;
+   g->label_cache_clock = 0;
+   g->label_cache_hits = 0;
+   g->label_cache_misses = 0;
+   g->label_capture = NULL;
+#endif
    #ifdef USE_COLOR_RGB888
    g->desktop_color = 0x5E8BEf;
    #endif
@@ -4617,6 +4771,7 @@ void UG_FillScreen( UG_COLOR c )
 void UG_FillFrame( UG_S16 x1, UG_S16 y1, UG_S16 x2, UG_S16 y2, UG_COLOR c )
 {
    UG_S16 n,m;
+   UG_RESULT r;
 
    if ( x2 < x1 )
    {
@@ -4631,10 +4786,16 @@ void UG_FillFrame( UG_S16 x1, UG_S16 y1, UG_S16 x2, UG_S16 y2, UG_COLOR c )
       y1 = n;
    }
 
+   _UG_STAT_ADD( fill_pixels, (UG_U32)(x2-x1+1)*(y2-y1+1) );
+
    /* Is hardware acceleration available? */
    if ( gui->driver[DRIVER_FILL_FRAME].state & DRIVER_ENABLED )
    {
-      if( ((UG_RESULT(*)(UG_S16 x1, UG_S16 y1, UG_S16 x2, UG_S16 y2, UG_COLOR c))gui->driver[DRIVER_FILL_FRAME].driver)(x1,y1,x2,y2,c) == UG_RESULT_OK ) return;
+      _UG_STAT_ADD( driver_calls[DRIVER_FILL_FRAME], 1 );
+      _UG_TRACE_BEGIN( TRACE_DRIVER, DRIVER_FILL_FRAME, 0 );
+      r = ((UG_RESULT(*)(UG_S16 x1, UG_S16 y1, UG_S16 x2, UG_S16 y2, UG_COLOR c))gui->driver[DRIVER_FILL_FRAME].driver)(x1,y1,x2,y2,c);
+      _UG_TRACE_END( TRACE_DRIVER, DRIVER_FILL_FRAME, 0 );
+      if ( r == UG_RESULT_OK ) return;
    }
 
    for( m=y1; m<=y2; m++ )
@@ -4886,17 +5047,23 @@ void UG_DrawArc( UG_S16 x0, UG_S16 y0, UG_S16 r, UG_U8 s, UG_COLOR c )
 void UG_DrawLine( UG_S16 x1, UG_S16 y1, UG_S16 x2, UG_S16 y2, UG_COLOR c )
 {
    UG_S16 n, dx, dy, sgndx, sgndy, dxabs, dyabs, x, y, drawx, drawy;
-
-   /* Is hardware acceleration available? */
-   if ( gui->driver[DRIVER_DRAW_LINE].state & DRIVER_ENABLED )
-   {
-      if( ((UG_RESULT(*)(UG_S16 x1, UG_S16 y1, UG_S16 x2, UG_S16 y2, UG_COLOR c))gui->driver[DRIVER_DRAW_LINE].driver)(x1,y1,x2,y2,c) == UG_RESULT_OK ) return;
-   }
+   UG_RESULT r;
 
    dx = x2 - x1;
    dy = y2 - y1;
    dxabs = (dx>0)?dx:-dx;
    dyabs = (dy>0)?dy:-dy;
+   _UG_STAT_ADD( line_pixels, (UG_U32)((dxabs > dyabs) ? dxabs : dyabs) + 1 );
+
+   /* Is hardware acceleration available? */
+   if ( gui->driver[DRIVER_DRAW_LINE].state & DRIVER_ENABLED )
+   {
+      _UG_STAT_ADD( driver_calls[DRIVER_DRAW_LINE], 1 );
+      _UG_TRACE_BEGIN( TRACE_DRIVER, DRIVER_DRAW_LINE, 0 );
+      r = ((UG_RESULT(*)(UG_S16 x1, UG_S16 y1, UG_S16 x2, UG_S16 y2, UG_COLOR c))gui->driver[DRIVER_DRAW_LINE].driver)(x1,y1,x2,y2,c);
+      _UG_TRACE_END( TRACE_DRIVER, DRIVER_DRAW_LINE, 0 );
+      if ( r == UG_RESULT_OK ) return;
+   }
    sgndx = (dx>0)?1:-1;
    sgndy = (dy>0)?1:-1;
    x = dyabs >> 1;
@@ -4939,30 +5106,30 @@ void UG_DrawLine( UG_S16 x1, UG_S16 y1, UG_S16 x2, UG_S16 y2, UG_COLOR c )
 void UG_PutString( UG_S16 x, UG_S16 y, char* str )
 {
    UG_S16 xp,yp;
-   UG_U8 cw;
-   char chr;
+   UG_S16 cw;
+   UG_U16 chr;
 
    xp=x;
    yp=y;
 
    while ( *str != 0 )
    {
-      chr = *str++;
-	  if (chr < gui->font.start_char || chr > gui->font.end_char) continue;
+      chr = _UG_DecodeChar( &str );
       if ( chr == '\n' )
       {
          xp = gui->x_dim;
          continue;
       }
-	  cw = gui->font.widths ? gui->font.widths[chr - gui->font.start_char] : gui->font.char_width;
+      cw = _UG_GetCharWidth( &gui->font, chr );
+      if ( !cw ) continue;
 
       if ( xp + cw > gui->x_dim - 1 )
       {
          xp = x;
-         yp += gui->font.char_height+gui->char_v_space;
+         yp += _UG_GetCharHeight( &gui->font )+gui->char_v_space;
       }
 
-      UG_PutChar(chr, xp, yp, gui->fore_color, gui->back_color);
+      _UG_PutChar(chr,xp,yp,gui->fore_color,gui->back_color,&gui->font,gui->transparent_font);
 
       xp += cw + gui->char_h_space;
    }
@@ -4970,41 +5137,40 @@ void UG_PutString( UG_S16 x, UG_S16 y, char* str )
 
 void UG_PutChar( char chr, UG_S16 x, UG_S16 y, UG_COLOR fc, UG_COLOR bc )
 {
-	_UG_PutChar(chr,x,y,fc,bc,&gui->font);
+	_UG_PutChar((UG_U8)chr,x,y,fc,bc,&gui->font,gui->transparent_font);
 }
 
 void UG_ConsolePutString( char* str )
 {
-   char chr;
-   UG_U8 cw;
+   UG_U16 chr;
+   UG_S16 cw;
 
    while ( *str != 0 )
    {
-      chr = *str;
+      chr = _UG_DecodeChar( &str );
       if ( chr == '\n' )
       {
          gui->console.x_pos = gui->x_dim;
-         str++;
          continue;
       }
       
-      cw = gui->font.widths ? gui->font.widths[chr - gui->font.start_char] : gui->font.char_width;
+      cw = _UG_GetCharWidth( &gui->font, chr );
+      if ( !cw ) continue;
       gui->console.x_pos += cw+gui->char_h_space;
 
       if ( gui->console.x_pos+cw > gui->console.x_end )
       {
          gui->console.x_pos = gui->console.x_start;
-         gui->console.y_pos += gui->font.char_height+gui->char_v_space;
+         gui->console.y_pos += _UG_GetCharHeight( &gui->font )+gui->char_v_space;
       }
-      if ( gui->console.y_pos+gui->font.char_height > gui->console.y_end )
+      if ( gui->console.y_pos+_UG_GetCharHeight( &gui->font ) > gui->console.y_end )
       {
          gui->console.x_pos = gui->console.x_start;
          gui->console.y_pos = gui->console.y_start;
          UG_FillFrame(gui->console.x_start,gui->console.y_start,gui->console.x_end,gui->console.y_end,gui->console.back_color);
       }
 
-      UG_PutChar(chr, gui->console.x_pos, gui->console.y_pos, gui->console.fore_color, gui->console.back_color);
-      str++;
+      _UG_PutChar(chr,gui->console.x_pos,gui->console.y_pos,gui->console.fore_color,gui->console.back_color,&gui->font,gui->transparent_font);
    }
 }
 
@@ -5056,6 +5222,53 @@ void UG_FontSetVSpace( UG_U16 s )
    gui->char_v_space = s;
 }
 
+void UG_FontSetTransparency( UG_U8 t )
+{
+   gui->transparent_font = t;
+}
+
+#ifdef USE_FONT_PAGING
+void UG_FontCacheFlush( void )
+{
+   UG_U16 i;
+
+   for(i=0;i<UG_FONT_CACHE_SLOTS;i++)
+   {
+      gui->font_cache[i].p = NULL;
+      gui->font_cache[i].stamp = 0;
+   }
+}
+
+void UG_FontCacheGetStats( UG_U32* hits, UG_U32* misses )
+{
+   if ( hits != NULL ) *hits = gui->font_cache_hits;
+   if ( misses != NULL ) *misses = gui->font_cache_misses;
+}
+#endif
+
+#ifdef USE_BLEND_CACHE
+void UG_BlendCacheGetStats( UG_U32* hits, UG_U32* misses )
+{
+   if ( hits != NULL ) *hits = gui->blend_cache_hits;
+   if ( misses != NULL ) *misses = gui->blend_cache_misses;
+}
+#endif
+
+#ifdef USE_LABEL_CACHE
+void UG_LabelCacheFlush( void )
+{
+   UG_U16 i;
+
+   for(i=0;i<UG_LABEL_CACHE_SLOTS;i++) gui->label_cache[i].stamp = 0;
+}
+
+void UG_LabelCacheGetStats( UG_U32* hits, UG_U32* misses )
+{
+   if ( hits != NULL ) *hits = gui->label_cache_hits;
+   if ( misses != NULL ) *misses = gui->label_cache_misses;
+}
+#endif
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -5253,52 +5466,79 @@ const UG_COLOR pal_checkbox_released[] =
 /* -------------------------------------------------------------------------------- */
 /* -- INTERNAL FUNCTIONS                                                         -- */
 /* -------------------------------------------------------------------------------- */
-void _UG_PutChar( char chr, UG_S16 x, UG_S16 y, UG_COLOR fc, UG_COLOR bc, const UG_FONT* font)
+void _UG_PutChar( UG_U16 chr, UG_S16 x, UG_S16 y, UG_COLOR fc, UG_COLOR bc, const UG_FONT* font, UG_U8 transparent )
 {
-   UG_U16 i,j,k,xo,yo,c,bn,actual_char_width;
-   UG_U8 b,bt;
+   UG_U16 i,j,k,c,bn,g,w,h,pitch;
+   UG_U8 b,s;
+   const UG_FONT_BBOX* bb;
    UG_U32 index;
-   UG_COLOR color;
+   UG_COLOR buf[16];
+   const UG_COLOR* lut;
+   const UG_U8* p;
    void(*push_pixel)(UG_COLOR);
 
-   bt = (UG_U8)chr;
-
-   switch ( bt )
-   {
-      case 0xF6: bt = 0x94; break; // 
-      case 0xD6: bt = 0x99; break; // 
-      case 0xFC: bt = 0x81; break; // 
-      case 0xDC: bt = 0x9A; break; // 
-      case 0xE4: bt = 0x84; break; // 
-      case 0xC4: bt = 0x8E; break; // 
-      case 0xB5: bt = 0xE6; break; // 
-      case 0xB0: bt = 0xF8; break; // 
+   g = _UG_GetGlyph( font, chr );
+   if ( g == FONT_NO_GLYPH ) return;
+   
+   if ( !font->char_width ) return;
+   s = ( font->scale > 1 ) ? font->scale : 1;
+   w = (font->widths ? font->widths[g] : font->char_width);
+   h = font->char_height;
+   pitch = font->char_width;
+   _UG_STAT_ADD( glyphs, 1 );
+   _UG_STAT_ADD( glyph_pixels, (UG_U32)w*h*s*s );
+   if ( font->offsets && ((font->font_type == FONT_TYPE_4BPP) || (font->font_type == FONT_TYPE_2BPP)) ) pitch = w;
+
+   /* Only the ink box of the glyph is stored, the rest of the cell is background */
+   if ( font->bboxes != NULL )
+   {
+      bb = &font->bboxes[g];
+      if ( !transparent )
+      {
+         if ( bb->y ) _UG_PutGlyphRun(x,y,0,0,w,bb->y,s,bc);
+         if ( bb->y+bb->h < h ) _UG_PutGlyphRun(x,y,0,bb->y+bb->h,w,h-bb->y-bb->h,s,bc);
+         if ( bb->h && bb->x ) _UG_PutGlyphRun(x,y,0,bb->y,bb->x,bb->h,s,bc);
+         if ( bb->h && (bb->x+bb->w < w) ) _UG_PutGlyphRun(x,y,bb->x+bb->w,bb->y,w-bb->x-bb->w,bb->h,s,bc);
+      }
+      if ( !bb->w || !bb->h ) return;
+      x += bb->x*s;
+      y += bb->y*s;
+      w = bb->w;
+      h = bb->h;
+      pitch = bb->w;
    }
 
-   if (bt < font->start_char || bt > font->end_char) return;
-   
-   yo = y;
-   bn = font->char_width;
-   if ( !bn ) return;
-   bn >>= 3;
-   if ( font->char_width % 8 ) bn++;
-   actual_char_width = (font->widths ? font->widths[bt - font->start_char] : font->char_width);
+   bn = (pitch + 7) >> 3;
+   p = _UG_GetGlyphData( font, g );
+   if ( p == NULL ) return;
 
-   /* Is hardware acceleration available? */
-   if ( gui->driver[DRIVER_FILL_AREA].state & DRIVER_ENABLED )
+   /* Anti-aliased glyphs only have a few levels, so they are blended once */
+   lut = NULL;
+   if ( font->font_type == FONT_TYPE_4BPP ) lut = _UG_GetBlendLUT( fc, bc, 16, buf );
+   else if ( font->font_type == FONT_TYPE_2BPP ) lut = _UG_GetBlendLUT( fc, bc, 4, buf );
+   else if ( font->font_type == FONT_TYPE_8BPP ) lut = _UG_GetBlendLUT( fc, bc, 256, NULL );
+
+   /* Is hardware acceleration available? Transparent text can't use it,  */
+   /* because the fill area driver writes every pixel of the window. Scaled */
+   /* text draws each pixel as a filled block instead.                     */
+   if ( !transparent && (s == 1) && (gui->driver[DRIVER_FILL_AREA].state & DRIVER_ENABLED) )
    {
 	   //(void(*)(UG_COLOR))
-      push_pixel = ((void*(*)(UG_S16, UG_S16, UG_S16, UG_S16))gui->driver[DRIVER_FILL_AREA].driver)(x,y,x+actual_char_width-1,y+font->char_height-1);
+      _UG_TRACE_BEGIN( TRACE_DRIVER, DRIVER_FILL_AREA, 0 );
+      push_pixel = ((void*(*)(UG_S16, UG_S16, UG_S16, UG_S16))gui->driver[DRIVER_FILL_AREA].driver)(x,y,x+w-1,y+h-1);
+      _UG_TRACE_END( TRACE_DRIVER, DRIVER_FILL_AREA, 0 );
+      _UG_STAT_ADD( driver_calls[DRIVER_FILL_AREA], 1 );
+      _UG_STAT_ADD( push_bytes, (UG_U32)w*h*sizeof(UG_COLOR) );
 	   
       if (font->font_type == FONT_TYPE_1BPP)
 	  {
-	      index = (bt - font->start_char)* font->char_height * bn;
-		  for( j=0;j<font->char_height;j++ )
+	      index = 0;
+		  for( j=0;j<h;j++ )
 		  {
-			 c=actual_char_width;
+			 c=w;
 			 for( i=0;i<bn;i++ )
 			 {
-				b = font->p[index++];
+				b = p[index++];
 				for( k=0;(k<8) && c;k++ )
 				{
 				   if( b & 0x01 )
@@ -5317,261 +5557,1430 @@ void _UG_PutChar( char chr, UG_S16 x, UG_S16 y, UG_COLOR fc, UG_COLOR bc, const
 	  }
 	  else if (font->font_type == FONT_TYPE_8BPP)
 	  {
-		   index = (bt - font->start_char)* font->char_height * font->char_width;
-		   for( j=0;j<font->char_height;j++ )
+		   index = 0;
+		   for( j=0;j<h;j++ )
 		   {
-			  for( i=0;i<actual_char_width;i++ )
+			  for( i=0;i<w;i++ )
 			  {
-				 b = font->p[index++];
-				 color = (((fc & 0xFF) * b + (bc & 0xFF) * (256 - b)) >> 8) & 0xFF |//Blue component
-				         (((fc & 0xFF00) * b + (bc & 0xFF00) * (256 - b)) >> 8)  & 0xFF00|//Green component
-				         (((fc & 0xFF0000) * b + (bc & 0xFF0000) * (256 - b)) >> 8) & 0xFF0000; //Red component
-				 push_pixel(color);
+				 b = p[index++];
+				 push_pixel(lut ? lut[b] : _UG_BlendColor(fc,bc,b));
 			  }
-			  index += font->char_width - actual_char_width;
+			  index += pitch - w;
 		  }
 	  }
+      else if (font->font_type == FONT_TYPE_1BPP_RLE)
+      {
+         _UG_PutCharRLE(x,y,w,h,p,fc,bc,0,1,push_pixel);
+      }
+      else if ( (font->font_type == FONT_TYPE_4BPP) || (font->font_type == FONT_TYPE_2BPP) )
+      {
+         _UG_PutCharAA(x,y,w,h,p,( font->font_type == FONT_TYPE_4BPP ) ? 4:2,pitch,lut,0,1,push_pixel);
+      }
    }
    else
    {
 	   /*Not accelerated output*/
 	   if (font->font_type == FONT_TYPE_1BPP)
 	   {
-         index = (bt - font->start_char)* font->char_height * bn;
-         for( j=0;j<font->char_height;j++ )
+         /* Runs of equal pixels are drawn at once, transparent text only */
+         /* draws the foreground runs                                   */
+         index = 0;
+         for( j=0;j<h;j++ )
          {
-           xo = x;
-           c=actual_char_width;
-           for( i=0;i<bn;i++ )
-           {
-             b = font->p[index++];
-             for( k=0;(k<8) && c;k++ )
-             {
-               if( b & 0x01 )
-               {
-                  gui->pset(xo,yo,fc);
-               }
-               else
+            i = 0;
+            while ( i < w )
+            {
+               b = p[index + (i >> 3)] >> (i & 7);
+               if ( transparent && !b )
                {
-                  gui->pset(xo,yo,bc);
+                  /* Skip the rest of the byte */
+                  i = (i | 7) + 1;
+                  continue;
                }
-               b >>= 1;
-               xo++;
-               c--;
-             }
-           }
-           yo++;
+               b &= 0x01;
+               k = i + 1;
+               while ( (k < w) && (((p[index + (k >> 3)] >> (k & 7)) & 0x01) == b) ) k++;
+               if ( b || !transparent ) _UG_PutGlyphRun(x,y,i,j,k-i,1,s,b ? fc:bc);
+               i = k;
+            }
+            index += bn;
          }
       }
       else if (font->font_type == FONT_TYPE_8BPP)
       {
-         index = (bt - font->start_char)* font->char_height * font->char_width;
-         for( j=0;j<font->char_height;j++ )
+         index = 0;
+         for( j=0;j<h;j++ )
          {
-            xo = x;
-            for( i=0;i<actual_char_width;i++ )
+            for( i=0;i<w;i++ )
             {
-               b = font->p[index++];
-               color = (((fc & 0xFF) * b + (bc & 0xFF) * (256 - b)) >> 8) & 0xFF |//Blue component
-                       (((fc & 0xFF00) * b + (bc & 0xFF00) * (256 - b)) >> 8)  & 0xFF00|//Green component
-                       (((fc & 0xFF0000) * b + (bc & 0xFF0000) * (256 - b)) >> 8) & 0xFF0000; //Red component
-               gui->pset(xo,yo,color);
-               xo++;
+               b = p[index++];
+               /* Transparent text skips pixels without coverage */
+               if ( b || !transparent ) _UG_PutGlyphRun(x,y,i,j,1,1,s,lut ? lut[b] : _UG_BlendColor(fc,bc,b));
             }
-            index += font->char_width - actual_char_width;
-            yo++;
+            index += pitch - w;
          }
       }
+      else if (font->font_type == FONT_TYPE_1BPP_RLE)
+      {
+         _UG_PutCharRLE(x,y,w,h,p,fc,bc,transparent,s,NULL);
+      }
+      else if ( (font->font_type == FONT_TYPE_4BPP) || (font->font_type == FONT_TYPE_2BPP) )
+      {
+         _UG_PutCharAA(x,y,w,h,p,( font->font_type == FONT_TYPE_4BPP ) ? 4:2,pitch,lut,transparent,s,NULL);
+      }
    }
 }
 
-void _UG_PutText(UG_TEXT* txt)
+/* Draws n x rows glyph pixels starting at column i, row j of the glyph at */
+/* x/y. With a scale s > 1 every pixel becomes an s x s block.            */
+void _UG_PutGlyphRun( UG_S16 x, UG_S16 y, UG_U16 i, UG_U16 j, UG_U16 n, UG_U16 rows, UG_U8 s, UG_COLOR c )
 {
-   UG_U16 sl,rc,wl;
-   UG_S16 xp,yp;
-   UG_S16 xs=txt->a.xs;
-   UG_S16 ys=txt->a.ys;
-   UG_S16 xe=txt->a.xe;
-   UG_S16 ye=txt->a.ye;
-   UG_U8  align=txt->align;
-   UG_S16 char_width=txt->font->char_width;
-   UG_S16 char_height=txt->font->char_height;
-   UG_S16 char_h_space=txt->h_space;
-   UG_S16 char_v_space=txt->v_space;
+   if ( (n == 1) && (rows == 1) && (s == 1) ) gui->pset(x+i,y+j,c);
+   else UG_FillFrame(x+i*s,y+j*s,x+(i+n)*s-1,y+(j+rows)*s-1,c);
+}
 
-   char chr;
+/* Draws a FONT_TYPE_1BPP_RLE glyph. Without push_pixel each run is drawn as */
+/* one filled rectangle covering all repeated rows.                          */
+void _UG_PutCharRLE( UG_S16 x, UG_S16 y, UG_U16 w, UG_U16 h, const UG_U8* p, UG_COLOR fc, UG_COLOR bc, UG_U8 transparent, UG_U8 s, void(*push_pixel)(UG_COLOR) )
+{
+   UG_U32 ni,row;
+   UG_U16 j,xo,run,rep,k;
+   UG_U8 v,fg,first;
+   UG_COLOR color;
 
-   char* str = txt->str;
-   char* c = str;
+   ni = 0;
+   j = 0;
+   while ( j < h )
+   {
+      rep = (p[ni>>1] >> ((ni & 1) ? 0:4)) & 0x0F;
+      ni++;
+      if ( rep >= h - j ) rep = h - j - 1;
+      row = ni;
 
-   if ( txt->font->p == NULL ) return;
-   if ( str == NULL ) return;
-   if ( (ye - ys) < txt->font->char_height ) return;
+      for( k=0;k<=rep;k++ )
+      {
+         ni = row;
+         xo = 0;
+         run = 0;
+         fg = 0;
+         first = 1;
+         while ( xo < w )
+         {
+            v = (p[ni>>1] >> ((ni & 1) ? 0:4)) & 0x0F;
+            ni++;
+            run += v;
+            if ( v == 15 ) continue;
+            if ( !run )
+            {
+               if ( first )
+               {
+                  /* Row starts with foreground */
+                  fg = 1;
+                  first = 0;
+                  continue;
+               }
+               /* Rest of the row is background */
+               fg = 0;
+               run = w - xo;
+            }
+            if ( run > w - xo ) return;
+            color = fg ? fc:bc;
 
-   rc=1;
-   c=str;
-   while ( *c != 0 )
-   {
-      if ( *c == '\n' ) rc++;
-      c++;
-   }
+            if ( push_pixel != NULL )
+            {
+               xo += run;
+               while ( run-- ) push_pixel(color);
+            }
+            else
+            {
+               /* Transparent text skips the background runs */
+               if ( fg || !transparent ) _UG_PutGlyphRun(x,y,xo,j,run,rep+1,s,color);
+               xo += run;
+            }
+            run = 0;
+            fg ^= 1;
+            first = 0;
+         }
 
-   yp = 0;
-   if ( align & (ALIGN_V_CENTER | ALIGN_V_BOTTOM) )
-   {
-      yp = ye - ys + 1;
-      yp -= char_height*rc;
-      yp -= char_v_space*(rc-1);
-      if ( yp < 0 ) return;
+         /* Repeated rows are already covered by the rectangles */
+         if ( push_pixel == NULL ) break;
+      }
+      j += rep + 1;
    }
-   if ( align & ALIGN_V_CENTER ) yp >>= 1;
-   yp += ys;
+}
+
+/* Draws a FONT_TYPE_4BPP / FONT_TYPE_2BPP glyph of w x h pixels, whose rows */
+/* are 'pitch' pixels apart. lut holds the colors of the coverage levels.    */
+/* Without push_pixel runs of one level are drawn as one line.              */
+void _UG_PutCharAA( UG_S16 x, UG_S16 y, UG_U16 w, UG_U16 h, const UG_U8* p, UG_U8 bpp, UG_U16 pitch, const UG_COLOR* lut, UG_U8 transparent, UG_U8 s, void(*push_pixel)(UG_COLOR) )
+{
+   UG_U16 i,j,k;
+   UG_U8 v,mask;
 
-   while( 1 )
+   mask = (1 << bpp) - 1;
+   for( j=0;j<h;j++ )
    {
-      sl=0;
-      c=str;
-      wl = 0;
-      while( (*c != 0) && (*c != '\n') )
+      i = 0;
+      while ( i < w )
       {
-         if (*c < txt->font->start_char || *c > txt->font->end_char) {c++; continue;}
-         sl++;
-         wl += (txt->font->widths ? txt->font->widths[*c - txt->font->start_char] : char_width) + char_h_space;
-         c++;
+         v = (p[(i * bpp) >> 3] >> (8 - bpp - ((i * bpp) & 7))) & mask;
+         if ( push_pixel != NULL )
+         {
+            push_pixel(lut[v]);
+            i++;
+            continue;
+         }
+
+         k = i + 1;
+         while ( (k < w) && (((p[(k * bpp) >> 3] >> (8 - bpp - ((k * bpp) & 7))) & mask) == v) ) k++;
+         /* Transparent text skips pixels without coverage */
+         if ( v || !transparent ) _UG_PutGlyphRun(x,y,i,j,k-i,1,s,lut[v]);
+         i = k;
       }
-      wl -= char_h_space;
+      p += (pitch * bpp + 7) >> 3;
+   }
+}
+
+/* Blends fc over bc with alpha 0 (bc) ... 255 */
+UG_COLOR _UG_BlendColor( UG_COLOR fc, UG_COLOR bc, UG_U8 alpha )
+{
+#ifdef USE_COLOR_RGB565
+   UG_U32 f,b;
+   UG_U8 a;
+
+   /* Spread the channels to 00000gggggg00000rrrrr000000bbbbb, so that */
+   /* all of them are blended (and rounded) by one multiplication.    */
+   f = (fc | ((UG_U32)fc << 16)) & 0x07E0F81F;
+   b = (bc | ((UG_U32)bc << 16)) & 0x07E0F81F;
+   a = (alpha + 4) >> 3;
+   f = ((f * a + b * (32 - a) + 0x02008010) >> 5) & 0x07E0F81F;
+   return (UG_COLOR)(f | (f >> 16));
+#else
+   UG_U16 a;
+
+   /* 0..256, so that full coverage gives exactly fc */
+   a = alpha + (alpha >> 7);
+   return ((((fc & 0xFF) * a + (bc & 0xFF) * (256 - a)) >> 8) & 0xFF) |            //Blue component
+          ((((fc & 0xFF00) * a + (bc & 0xFF00) * (256 - a)) >> 8) & 0xFF00) |      //Green component
+          ((((fc & 0xFF0000) * a + (bc & 0xFF0000) * (256 - a)) >> 8) & 0xFF0000); //Red component
+#endif
+}
+
+/* Fills lut with the colors of the coverage levels of an anti-aliased font */
+void _UG_BlendLevels( UG_COLOR* lut, UG_U16 levels, UG_COLOR fc, UG_COLOR bc )
+{
+   UG_U16 i;
 
-      xp = xe - xs + 1;
-      xp -= wl;
-      if ( xp < 0 ) return;
+   for( i=0;i<levels;i++ ) lut[i] = _UG_BlendColor( fc, bc, (UG_U8)((i * 255) / (levels - 1)) );
+}
 
-      if ( align & ALIGN_H_LEFT ) xp = 0;
-      else if ( align & ALIGN_H_CENTER ) xp >>= 1;
-      xp += xs;
+/* Returns the colors of the coverage levels for fc over bc. With           */
+/* USE_BLEND_CACHE they come from the cache (the least recently used slot   */
+/* is refilled on a miss), otherwise they are blended into buf. Returns     */
+/* NULL if neither can hold the levels.                                     */
+const UG_COLOR* _UG_GetBlendLUT( UG_COLOR fc, UG_COLOR bc, UG_U16 levels, UG_COLOR* buf )
+{
+#ifdef USE_BLEND_CACHE
+   UG_BLEND_CACHE_SLOT* s;
+   UG_BLEND_CACHE_SLOT* lru;
+   UG_U16 i;
 
-      while( (*str != '\n') )
+   if ( levels <= UG_BLEND_CACHE_LEVELS )
+   {
+      gui->blend_cache_clock++;
+      lru = &gui->blend_cache[0];
+      for(i=0;i<UG_BLEND_CACHE_SLOTS;i++)
       {
-         chr = *str++;
-         if ( chr == 0 ) return;
-         _UG_PutChar(chr,xp,yp,txt->fc,txt->bc,txt->font);
-         xp += (txt->font->widths ? txt->font->widths[chr - txt->font->start_char] : char_width) + char_h_space;
+         s = &gui->blend_cache[i];
+         if ( (s->fc == fc) && (s->bc == bc) && (s->levels == levels) && s->stamp )
+         {
+            s->stamp = gui->blend_cache_clock;
+            gui->blend_cache_hits++;
+            return s->lut;
+         }
+         if ( s->stamp < lru->stamp ) lru = s;
       }
-      str++;
-      yp += char_height + char_v_space;
+
+      gui->blend_cache_misses++;
+      _UG_BlendLevels( lru->lut, levels, fc, bc );
+      lru->fc = fc;
+      lru->bc = bc;
+      lru->levels = levels;
+      lru->stamp = gui->blend_cache_clock;
+      return lru->lut;
    }
+#endif
+   if ( buf == NULL ) return NULL;
+   _UG_BlendLevels( buf, levels, fc, bc );
+   return buf;
 }
 
-UG_OBJECT* _UG_GetFreeObject( UG_WINDOW* wnd )
+/* FNV-1a hash of a string, used to detect changed texts */
+UG_U32 _UG_HashString( const char* str )
 {
-   UG_U8 i;
-   UG_OBJECT* obj=(UG_OBJECT*)wnd->objlst;
+   UG_U32 hash;
 
-   for(i=0;i<wnd->objcnt;i++)
+   hash = 0x811C9DC5;
+   if ( str == NULL ) return 0;
+   while ( *str ) hash = (hash ^ (UG_U8)*str++) * 0x01000193;
+   return hash;
+}
+
+/* Reads one character from a string and advances the string pointer. With */
+/* USE_UTF8 invalid sequences and characters beyond U+FFFF return U+FFFD.   */
+UG_U16 _UG_DecodeChar( char** str )
+{
+#ifdef USE_UTF8
+   const UG_U8* s = (const UG_U8*)*str;
+   UG_U32 c;
+   UG_U8 n;
+
+   c = *s++;
+   if ( c < 0x80 ) n = 0;
+   else if ( c < 0xC0 )
    {
-      obj = (UG_OBJECT*)(&wnd->objlst[i]);
-      if ( (obj->state & OBJ_STATE_FREE) && (obj->state & OBJ_STATE_VALID) )
+      /* Stray continuation byte */
+      n = 0;
+      c = 0xFFFD;
+   }
+   else if ( c < 0xE0 )
+   {
+      n = 1;
+      c &= 0x1F;
+   }
+   else if ( c < 0xF0 )
+   {
+      n = 2;
+      c &= 0x0F;
+   }
+   else
+   {
+      n = 3;
+      c &= 0x07;
+   }
+   while ( n-- )
+   {
+      if ( (*s & 0xC0) != 0x80 )
       {
-         /* Free object found! */
-         return obj;
+         c = 0xFFFD;
+         break;
       }
+      c = (c << 6) | (*s++ & 0x3F);
    }
-   return NULL;
+   *str = (char*)s;
+   return ( c > 0xFFFF ) ? 0xFFFD : (UG_U16)c;
+#else
+   return (UG_U8)*(*str)++;
+#endif
 }
 
-UG_OBJECT* _UG_SearchObject( UG_WINDOW* wnd, UG_U8 type, UG_U8 id )
+/* Returns the glyph index of a character or FONT_NO_GLYPH */
+UG_U16 _UG_GetGlyph( const UG_FONT* font, UG_U16 chr )
 {
-   UG_U8 i;
-   UG_OBJECT* obj=(UG_OBJECT*)wnd->objlst;
+   const UG_FONT_RANGE* r;
+   UG_U16 lo,hi,m;
 
-   for(i=0;i<wnd->objcnt;i++)
+   if ( font->ranges == NULL )
    {
-      obj = (UG_OBJECT*)(&wnd->objlst[i]);
-      if ( !(obj->state & OBJ_STATE_FREE) && (obj->state & OBJ_STATE_VALID) )
+      /* Map Latin-1 characters to the code page 437 glyphs of the built-in fonts */
+      switch ( chr )
       {
-         if ( (obj->type == type) && (obj->id == id) )
-         {
-            /* Requested object found! */
-            return obj;
-         }
+         case 0xF6: chr = 0x94; break; // 
+         case 0xD6: chr = 0x99; break; // 
+         case 0xFC: chr = 0x81; break; // 
+         case 0xDC: chr = 0x9A; break; // 
+         case 0xE4: chr = 0x84; break; // 
+         case 0xC4: chr = 0x8E; break; // 
+         case 0xB5: chr = 0xE6; break; // 
+         case 0xB0: chr = 0xF8; break; // 
       }
+
+      if ( (chr < font->start_char) || (chr > font->end_char) ) return FONT_NO_GLYPH;
+      return chr - font->start_char;
    }
-   return NULL;
+
+   /* Text mostly stays inside one range, so try the last one first */
+   if ( (gui->last_ranges == font->ranges) && (gui->last_range < font->range_count) )
+   {
+      r = &font->ranges[gui->last_range];
+      if ( (chr >= r->first) && (chr <= r->last) ) return r->glyph + (chr - r->first);
+   }
+
+   lo = 0;
+   hi = font->range_count;
+   while ( lo < hi )
+   {
+      m = (lo + hi) >> 1;
+      r = &font->ranges[m];
+      if ( chr < r->first ) hi = m;
+      else if ( chr > r->last ) lo = m + 1;
+      else
+      {
+         gui->last_ranges = font->ranges;
+         gui->last_range = m;
+         return r->glyph + (chr - r->first);
+      }
+   }
+   return FONT_NO_GLYPH;
 }
 
-UG_RESULT _UG_DeleteObject( UG_WINDOW* wnd, UG_U8 type, UG_U8 id )
+/* Returns the advance of a character, 0 if the font has no glyph for it */
+UG_S16 _UG_GetCharWidth( const UG_FONT* font, UG_U16 chr )
 {
-   UG_OBJECT* obj=NULL;
+   UG_U16 g;
 
-   obj = _UG_SearchObject( wnd, type, id );
+   g = _UG_GetGlyph( font, chr );
+   if ( g == FONT_NO_GLYPH ) return 0;
+   return (font->widths ? font->widths[g] : font->char_width) * (( font->scale > 1 ) ? font->scale : 1);
+}
 
-   /* Object found? */
-   if ( obj != NULL )
+/* Returns the line height of a font */
+UG_S16 _UG_GetCharHeight( const UG_FONT* font )
+{
+   return font->char_height * (( font->scale > 1 ) ? font->scale : 1);
+}
+
+/* Returns the size of a glyph of a font without offsets */
+UG_U32 _UG_GetGlyphSize( const UG_FONT* font )
+{
+   UG_U32 bits;
+
+   switch ( font->font_type )
    {
-      /* We dont't want to delete a visible or busy object! */
-      if ( (obj->state & OBJ_STATE_VISIBLE) || (obj->state & OBJ_STATE_UPDATE) ) return UG_RESULT_FAIL;
-      obj->state = OBJ_STATE_INIT;
-      obj->data = NULL;
-      obj->event = 0;
-      obj->id = 0;
-      obj->touch_state = 0;
-      obj->type = 0;
-      obj->update = NULL;
-      return UG_RESULT_OK;
+      case FONT_TYPE_8BPP: bits = 8; break;
+      case FONT_TYPE_4BPP: bits = 4; break;
+      case FONT_TYPE_2BPP: bits = 2; break;
+      default: bits = 1;
    }
-   return UG_RESULT_FAIL;
+   return (UG_U32)font->char_height * ((font->char_width * bits + 7) >> 3);
 }
 
-void _UG_ProcessTouchData( UG_WINDOW* wnd )
+/* Returns the bitmap data of a glyph, NULL if it isn't available */
+const UG_U8* _UG_GetGlyphData( const UG_FONT* font, UG_U16 g )
 {
-   UG_S16 xp,yp;
-   UG_U16 i,objcnt;
-   UG_OBJECT* obj;
-   UG_U8 objstate;
-   UG_U8 objtouch;
-   UG_U8 tchstate;
+   UG_U32 offset;
+#ifdef USE_FONT_PAGING
+   UG_U32 size;
+#endif
 
-   xp = gui->touch.xp;
-   yp = gui->touch.yp;
-   tchstate = gui->touch.state;
+   if ( font->offsets != NULL ) offset = font->offsets[g];
+   else offset = (UG_U32)g * _UG_GetGlyphSize( font );
 
-   objcnt = wnd->objcnt;
-   for(i=0; i<objcnt; i++)
+   if ( font->read == NULL ) return &font->p[offset];
+
+#ifdef USE_FONT_PAGING
+   /* A glyph ends where the next one starts, the last offset is the end */
+   if ( font->offsets != NULL ) size = font->offsets[g+1] - offset;
+   else size = _UG_GetGlyphSize( font );
+   return _UG_FontCacheGet( font, offset, size );
+#else
+   return NULL;
+#endif
+}
+
+#ifdef USE_FONT_PAGING
+/* Looks up a glyph in the cache. On a miss the least recently used slot */
+/* is refilled through the read function of the font.                    */
+const UG_U8* _UG_FontCacheGet( const UG_FONT* font, UG_U32 offset, UG_U16 size )
+{
+   UG_FONT_CACHE_SLOT* s;
+   UG_FONT_CACHE_SLOT* lru;
+   UG_U16 i;
+
+   if ( size > UG_FONT_CACHE_SLOT_SIZE ) return NULL;
+
+   gui->font_cache_clock++;
+   lru = &gui->font_cache[0];
+   for(i=0;i<UG_FONT_CACHE_SLOTS;i++)
    {
-      obj = (UG_OBJECT*)&wnd->objlst[i];
-      objstate = obj->state;
-      objtouch = obj->touch_state;
-      if ( !(objstate & OBJ_STATE_FREE) && (objstate & OBJ_STATE_VALID) && (objstate & OBJ_STATE_VISIBLE) && !(objstate & OBJ_STATE_REDRAW))
+      s = &gui->font_cache[i];
+      if ( (s->p == font->p) && (s->offset == offset) && s->stamp )
       {
-         /* Process touch data */
-         if ( (tchstate) && xp != -1 )
+         s->stamp = gui->font_cache_clock;
+         gui->font_cache_hits++;
+         return s->data;
+      }
+      if ( s->stamp < lru->stamp ) lru = s;
+   }
+
+   gui->font_cache_misses++;
+   lru->stamp = 0;
+   if ( font->read( font, offset, lru->data, size ) != UG_RESULT_OK ) return NULL;
+   lru->p = font->p;
+   lru->offset = offset;
+   lru->stamp = gui->font_cache_clock;
+   return lru->data;
+}
+#endif
+
+/* Finds the end of a text line. Without TXT_STYLE_WORD_WRAP lines only end  */
+/* at '\n', otherwise also at the last space (or glyph) which fits the area. */
+/* With TXT_STYLE_ELLIPSIS a line which doesn't fit is cut so that "..."     */
+/* fits behind it. The same applies to the last line if last is set and the  */
+/* text continues. Returns the end of the visible part of the line, *next is */
+/* the start of the following line or NULL at the end of the text.           */
+char* _UG_BreakLine( UG_TEXT* txt, char* str, UG_U8 last, UG_S16* width, char** next, UG_U8* ellipsis )
+{
+   UG_S16 aw,w,nw,cw,ew,brkw,cutw;
+   UG_U16 chr;
+   char* s;
+   char* n;
+   char* brk;
+   char* cut;
+   UG_U8 style = txt->style;
+
+   aw = txt->a.xe - txt->a.xs + 1;
+   ew = 0;
+   if ( style & TXT_STYLE_ELLIPSIS )
+   {
+      cw = _UG_GetCharWidth( txt->font, '.' );
+      if ( cw ) ew = 3*cw + 2*txt->h_space;
+      else style &= ~TXT_STYLE_ELLIPSIS;
+   }
+
+   *ellipsis = 0;
+   w = 0;
+   brk = NULL;
+   brkw = 0;
+   cut = str;
+   cutw = 0;
+   s = str;
+   while ( (*s != 0) && (*s != '\n') )
+   {
+      n = s;
+      chr = _UG_DecodeChar( &n );
+      cw = _UG_GetCharWidth( txt->font, chr );
+      if ( !cw )
+      {
+         s = n;
+         continue;
+      }
+      nw = w ? w + txt->h_space + cw : cw;
+      if ( chr == ' ' )
+      {
+         brk = s;
+         brkw = w;
+      }
+      if ( nw > aw )
+      {
+         if ( style & TXT_STYLE_WORD_WRAP )
          {
-            if ( !(objtouch & OBJ_TOUCH_STATE_IS_PRESSED) )
+            if ( brk != NULL )
             {
-               objtouch |= OBJ_TOUCH_STATE_PRESSED_OUTSIDE_OBJECT | OBJ_TOUCH_STATE_CHANGED;
-               objtouch &= ~(OBJ_TOUCH_STATE_RELEASED_ON_OBJECT | OBJ_TOUCH_STATE_RELEASED_OUTSIDE_OBJECT | OBJ_TOUCH_STATE_CLICK_ON_OBJECT);
+               /* Break at the last space */
+               *width = brkw;
+               *next = brk + 1;
+               s = brk;
             }
-            objtouch &= ~OBJ_TOUCH_STATE_IS_PRESSED_ON_OBJECT;
-            if ( xp >= obj->a_abs.xs )
+            else
             {
-               if ( xp <= obj->a_abs.xe )
+               /* The word doesn't fit, break inside. At least one glyph */
+               /* has to be taken, otherwise the text never ends.        */
+               if ( s == str )
                {
-                  if ( yp >= obj->a_abs.ys )
-                  {
-                     if ( yp <= obj->a_abs.ye )
-                     {
-                        objtouch |= OBJ_TOUCH_STATE_IS_PRESSED_ON_OBJECT;
-                        if ( !(objtouch & OBJ_TOUCH_STATE_IS_PRESSED) )
-                        {
-                           objtouch &= ~OBJ_TOUCH_STATE_PRESSED_OUTSIDE_OBJECT;
-                           objtouch |= OBJ_TOUCH_STATE_PRESSED_ON_OBJECT;
-                        }
-                     }
-                  }
+                  w = nw;
+                  s = n;
+                  if ( (*s == 0) || (*s == '\n') ) break;
                }
+               *width = w;
+               *next = s;
             }
-            objtouch |= OBJ_TOUCH_STATE_IS_PRESSED;
+            if ( !last || !(style & TXT_STYLE_ELLIPSIS) ) return s;
+            break;
          }
-         else if ( objtouch & OBJ_TOUCH_STATE_IS_PRESSED )
+         else if ( style & TXT_STYLE_ELLIPSIS )
+         {
+            *next = NULL;
+            while ( (*s != 0) && (*s != '\n') ) s++;
+            if ( *s == '\n' ) *next = s + 1;
+            *ellipsis = 1;
+            *width = cutw ? cutw + txt->h_space + ew : ew;
+            return cut;
+         }
+      }
+      w = nw;
+      s = n;
+      if ( w + txt->h_space + ew <= aw )
+      {
+         cut = s;
+         cutw = w;
+      }
+   }
+
+   if ( (*s == 0) || (*s == '\n') )
+   {
+      /* End of the text or of a paragraph */
+      *width = w;
+      *next = ( *s == '\n' ) ? s + 1 : NULL;
+   }
+
+   /* The last line gets an ellipsis if the text continues */
+   if ( last && (*next != NULL) && (style & TXT_STYLE_ELLIPSIS) )
+   {
+      *ellipsis = 1;
+      if ( s > cut )
+      {
+         s = cut;
+         *width = cutw;
+      }
+      *width = *width ? *width + txt->h_space + ew : ew;
+   }
+   return s;
+}
+
+/* Returns the x offset of a line inside the text area, -1 if it doesn't fit */
+UG_S16 _UG_AlignLine( UG_TEXT* txt, UG_S16 width )
+{
+   UG_S16 xp;
+
+   xp = txt->a.xe - txt->a.xs + 1;
+   xp -= width;
+   if ( xp < 0 ) return -1;
+
+   if ( txt->align & ALIGN_H_LEFT ) xp = 0;
+   else if ( txt->align & ALIGN_H_CENTER ) xp >>= 1;
+   return xp;
+}
+
+/* Returns the number of lines which fit the text area. Only wrapped or */
+/* shortened text is limited, otherwise all lines are drawn.           */
+UG_U16 _UG_TextMaxLines( UG_TEXT* txt )
+{
+   if ( !(txt->style & (TXT_STYLE_WORD_WRAP | TXT_STYLE_ELLIPSIS)) ) return 0xFFFF;
+   return (txt->a.ye - txt->a.ys + 1 + txt->v_space) / (_UG_GetCharHeight( txt->font ) + txt->v_space);
+}
+
+/* Finds the line breaks, widths and positions in a single pass */
+void _UG_LayoutText( UG_TEXT* txt, UG_TEXT_LAYOUT* l )
+{
+   UG_U16 rc,n,max;
+   UG_S16 xp,yp,w;
+   UG_U8 e;
+   char* s;
+   char* end;
+   char* next;
+
+   l->valid = 1;
+   l->str = txt->str;
+   l->hash = _UG_HashString( txt->str );
+   l->font_p = txt->font->p;
+   l->font_scale = txt->font->scale;
+   l->a = txt->a;
+   l->lines = 0;
+
+   if ( txt->font->p == NULL ) return;
+   if ( txt->str == NULL ) return;
+   if ( (txt->a.ye - txt->a.ys) < _UG_GetCharHeight( txt->font ) ) return;
+
+   max = _UG_TextMaxLines( txt );
+
+   /* Lines from the first one which is too wide are not drawn */
+   n = 0xFFFF;
+   rc = 0;
+   s = txt->str;
+   while ( s != NULL )
+   {
+      end = _UG_BreakLine( txt, s, rc == max - 1, &w, &next, &e );
+      xp = _UG_AlignLine( txt, w );
+      if ( (xp < 0) && (n == 0xFFFF) ) n = rc;
+      if ( rc < UG_TEXT_LAYOUT_LINES )
+      {
+         l->line[rc].start = s - txt->str;
+         l->line[rc].len = end - s;
+         l->line[rc].x = txt->a.xs + xp;
+         l->line[rc].w = w;
+         l->line[rc].ellipsis = e;
+      }
+      rc++;
+      s = next;
+      if ( rc == UG_TEXT_LAYOUT_LINES ) l->rest = ( s != NULL ) ? s - txt->str : 0;
+      if ( rc == max ) break;
+   }
+
+   yp = 0;
+   if ( txt->align & (ALIGN_V_CENTER | ALIGN_V_BOTTOM) )
+   {
+      yp = txt->a.ye - txt->a.ys + 1;
+      yp -= _UG_GetCharHeight( txt->font )*rc;
+      yp -= txt->v_space*(rc-1);
+      if ( yp < 0 ) return;
+   }
+   if ( txt->align & ALIGN_V_CENTER ) yp >>= 1;
+   l->y = txt->a.ys + yp;
+   l->lines = ( n < rc ) ? n : rc;
+}
+
+/* Pushes row j of glyph g, background included, to push_pixel */
+void _UG_PushGlyphRow( const UG_FONT* font, UG_U16 g, UG_U16 j, UG_COLOR fc, UG_COLOR bc, const UG_COLOR* lut, void(*push_pixel)(UG_COLOR) )
+{
+   UG_U16 i,w,x0,x1,pitch;
+   UG_U8 bpp,v;
+   const UG_FONT_BBOX* bb;
+   const UG_U8* p;
+
+   w = (font->widths ? font->widths[g] : font->char_width);
+   pitch = font->char_width;
+   if ( font->offsets && ((font->font_type == FONT_TYPE_4BPP) || (font->font_type == FONT_TYPE_2BPP)) ) pitch = w;
+   x0 = 0;
+   x1 = w;
+   p = NULL;
+   if ( font->bboxes != NULL )
+   {
+      bb = &font->bboxes[g];
+      x0 = bb->x;
+      x1 = bb->x + bb->w;
+      pitch = bb->w;
+      if ( (j < bb->y) || (j >= bb->y + bb->h) ) x1 = x0;
+      j -= bb->y;
+   }
+   if ( x1 > x0 ) p = _UG_GetGlyphData( font, g );
+   if ( p == NULL ) x1 = x0;
+
+   for( i=0;i<x0;i++ ) push_pixel(bc);
+   if ( p == NULL )
+   {
+      /* Nothing to draw in this row */
+   }
+   else if ( font->font_type == FONT_TYPE_1BPP )
+   {
+      p += (UG_U32)j * ((pitch + 7) >> 3);
+      for( i=0;i<x1-x0;i++ ) push_pixel(((p[i >> 3] >> (i & 7)) & 0x01) ? fc:bc);
+   }
+   else if ( font->font_type == FONT_TYPE_8BPP )
+   {
+      p += (UG_U32)j * pitch;
+      for( i=0;i<x1-x0;i++ ) push_pixel(lut ? lut[p[i]] : _UG_BlendColor(fc,bc,p[i]));
+   }
+   else
+   {
+      bpp = ( font->font_type == FONT_TYPE_4BPP ) ? 4:2;
+      p += (UG_U32)j * ((pitch * bpp + 7) >> 3);
+      for( i=0;i<x1-x0;i++ )
+      {
+         v = (p[(i * bpp) >> 3] >> (8 - bpp - ((i * bpp) & 7))) & ((1 << bpp) - 1);
+         push_pixel(lut[v]);
+      }
+   }
+   for( i=x1;i<w;i++ ) push_pixel(bc);
+}
+
+/* Draws a whole text line through one fill area window, the spacing between */
+/* the characters included. Returns 0 if the line has to be drawn character  */
+/* by character: without the driver, for transparent or scaled text, RLE     */
+/* fonts (their rows can't be read on their own), negative spacing and paged */
+/* fonts, whose glyphs would be read again for every row.                   */
+UG_U8 _UG_PutTextLine( UG_TEXT* txt, char* s, char* end, UG_U8 e, UG_S16 x, UG_S16 y )
+{
+   const UG_FONT* font;
+   UG_U16 chr,g,j,k,n,h;
+   UG_S16 w,cw;
+   UG_COLOR buf[16];
+   const UG_COLOR* lut;
+   char* t;
+   void(*push_pixel)(UG_COLOR);
+
+   font = txt->font;
+   if ( !(gui->driver[DRIVER_FILL_AREA].state & DRIVER_ENABLED) ) return 0;
+   if ( (txt->style & (TXT_STYLE_TRANSPARENT | TXT_STYLE_FILLED)) == TXT_STYLE_TRANSPARENT ) return 0;
+   if ( (font->scale > 1) || (txt->h_space < 0) ) return 0;
+   if ( (font->font_type == FONT_TYPE_1BPP_RLE) || !font->char_width ) return 0;
+   if ( font->read != NULL ) return 0;
+
+   /* Width of the line */
+   w = -txt->h_space;
+   t = s;
+   n = e ? 3:0;
+   while ( (t < end) || n )
+   {
+      if ( t < end ) chr = _UG_DecodeChar( &t );
+      else
+      {
+         chr = '.';
+         n--;
+      }
+      cw = _UG_GetCharWidth( font, chr );
+      if ( cw ) w += cw + txt->h_space;
+   }
+   if ( w <= 0 ) return 1;
+
+   lut = NULL;
+   if ( font->font_type == FONT_TYPE_4BPP ) lut = _UG_GetBlendLUT( txt->fc, txt->bc, 16, buf );
+   else if ( font->font_type == FONT_TYPE_2BPP ) lut = _UG_GetBlendLUT( txt->fc, txt->bc, 4, buf );
+   else if ( font->font_type == FONT_TYPE_8BPP ) lut = _UG_GetBlendLUT( txt->fc, txt->bc, 256, NULL );
+
+   h = font->char_height;
+   _UG_TRACE_BEGIN( TRACE_DRIVER, DRIVER_FILL_AREA, 0 );
+   push_pixel = ((void*(*)(UG_S16, UG_S16, UG_S16, UG_S16))gui->driver[DRIVER_FILL_AREA].driver)(x,y,x+w-1,y+h-1);
+   _UG_TRACE_END( TRACE_DRIVER, DRIVER_FILL_AREA, 0 );
+   _UG_STAT_ADD( driver_calls[DRIVER_FILL_AREA], 1 );
+   _UG_STAT_ADD( push_bytes, (UG_U32)w*h*sizeof(UG_COLOR) );
+   for( j=0;j<h;j++ )
+   {
+      t = s;
+      n = e ? 3:0;
+      cw = 0;
+      while ( (t < end) || n )
+      {
+         if ( t < end ) chr = _UG_DecodeChar( &t );
+         else
+         {
+            chr = '.';
+            n--;
+         }
+         g = _UG_GetGlyph( font, chr );
+         if ( (g == FONT_NO_GLYPH) || (font->widths && !font->widths[g]) ) continue;
+         if ( cw ) for( k=0;k<txt->h_space;k++ ) push_pixel(txt->bc);
+         if ( !j )
+         {
+            _UG_STAT_ADD( glyphs, 1 );
+            _UG_STAT_ADD( glyph_pixels, (UG_U32)(font->widths ? font->widths[g] : font->char_width)*h );
+         }
+         _UG_PushGlyphRow( font, g, j, txt->fc, txt->bc, lut, push_pixel );
+         cw = 1;
+      }
+   }
+   return 1;
+}
+
+#ifdef USE_LABEL_CACHE
+/* Stores the pixels of a text which is rendered into the label cache */
+void _UG_LabelCachePset( UG_S16 x, UG_S16 y, UG_COLOR c )
+{
+   UG_LABEL_CACHE_SLOT* s;
+
+   s = gui->label_capture;
+   x -= gui->label_capture_x;
+   y -= gui->label_capture_y;
+   if ( (x >= 0) && (y >= 0) && (x < s->w) && (y < s->h) ) s->px[(UG_U32)y * s->w + x] = c;
+}
+
+void _UG_LabelCacheBlit( UG_LABEL_CACHE_SLOT* s, UG_S16 x, UG_S16 y )
+{
+   UG_U16 i,j,k;
+   UG_U32 n;
+   const UG_COLOR* px;
+   void(*push_pixel)(UG_COLOR);
+
+   if ( gui->driver[DRIVER_FILL_AREA].state & DRIVER_ENABLED )
+   {
+      _UG_TRACE_BEGIN( TRACE_DRIVER, DRIVER_FILL_AREA, 0 );
+      push_pixel = ((void*(*)(UG_S16, UG_S16, UG_S16, UG_S16))gui->driver[DRIVER_FILL_AREA].driver)(x,y,x+s->w-1,y+s->h-1);
+      _UG_TRACE_END( TRACE_DRIVER, DRIVER_FILL_AREA, 0 );
+      _UG_STAT_ADD( driver_calls[DRIVER_FILL_AREA], 1 );
+      _UG_STAT_ADD( push_bytes, (UG_U32)s->w*s->h*sizeof(UG_COLOR) );
+      n = (UG_U32)s->w * s->h;
+      px = s->px;
+      while ( n-- ) push_pixel(*px++);
+      return;
+   }
+
+   /* Runs of one color are drawn at once */
+   for( j=0;j<s->h;j++ )
+   {
+      px = &s->px[(UG_U32)j * s->w];
+      i = 0;
+      while ( i < s->w )
+      {
+         k = i + 1;
+         while ( (k < s->w) && (px[k] == px[i]) ) k++;
+         _UG_PutGlyphRun(x,y,i,j,k-i,1,1,px[i]);
+         i = k;
+      }
+   }
+}
+
+/* Draws a text from the label cache. On a miss it's rendered into the least */
+/* recently used slot first. Returns 0 if the text can't be cached:          */
+/* transparent text over an unknown background, more lines than the layout  */
+/* holds, a block larger than a slot or text marked TXT_STYLE_NO_CACHE.     */
+UG_U8 _UG_LabelCacheDraw( UG_TEXT* txt, UG_TEXT_LAYOUT* l )
+{
+   UG_LABEL_CACHE_SLOT* s;
+   UG_LABEL_CACHE_SLOT* lru;
+   UG_U32 hash,n;
+   UG_S16 xs,xe,h;
+   UG_U16 i;
+   UG_U8 fa,ff;
+   void (*pset)(UG_S16,UG_S16,UG_COLOR);
+
+   if ( gui->label_capture != NULL ) return 0;
+   if ( txt->style & TXT_STYLE_NO_CACHE ) return 0;
+   if ( (txt->style & (TXT_STYLE_TRANSPARENT | TXT_STYLE_FILLED)) == TXT_STYLE_TRANSPARENT ) return 0;
+   if ( !l->lines || (l->lines > UG_TEXT_LAYOUT_LINES) ) return 0;
+
+   /* Bounding box of the lines */
+   xs = l->line[0].x;
+   xe = l->line[0].x + l->line[0].w;
+   for(i=1;i<l->lines;i++)
+   {
+      if ( l->line[i].x < xs ) xs = l->line[i].x;
+      if ( l->line[i].x + l->line[i].w > xe ) xe = l->line[i].x + l->line[i].w;
+   }
+   h = _UG_GetCharHeight( txt->font ) * l->lines + txt->v_space * (l->lines - 1);
+   if ( (xe <= xs) || (h <= 0) || ((UG_U32)(xe - xs) * h > UG_LABEL_CACHE_SLOT_SIZE) ) return 0;
+
+   hash = l->hash;
+
+   gui->label_cache_clock++;
+   lru = &gui->label_cache[0];
+   for(i=0;i<UG_LABEL_CACHE_SLOTS;i++)
+   {
+      s = &gui->label_cache[i];
+      if ( s->stamp && (s->hash == hash) && (s->font_p == txt->font->p) && (s->font_scale == txt->font->scale)
+           && (s->fc == txt->fc) && (s->bc == txt->bc) && (s->aw == txt->a.xe - txt->a.xs) && (s->ah == txt->a.ye - txt->a.ys)
+           && (s->align == txt->align) && (s->style == txt->style) && (s->h_space == txt->h_space) && (s->v_space == txt->v_space) )
+      {
+         s->stamp = gui->label_cache_clock;
+         gui->label_cache_hits++;
+         _UG_LabelCacheBlit( s, txt->a.xs + s->x, txt->a.ys + s->y );
+         return 1;
+      }
+      if ( s->stamp < lru->stamp ) lru = s;
+   }
+
+   /* Render the text into the slot. The drivers would bypass pset. */
+   gui->label_cache_misses++;
+   s = lru;
+   s->hash = hash;
+   s->font_p = txt->font->p;
+   s->font_scale = txt->font->scale;
+   s->fc = txt->fc;
+   s->bc = txt->bc;
+   s->aw = txt->a.xe - txt->a.xs;
+   s->ah = txt->a.ye - txt->a.ys;
+   s->align = txt->align;
+   s->style = txt->style;
+   s->h_space = txt->h_space;
+   s->v_space = txt->v_space;
+   s->x = xs - txt->a.xs;
+   s->y = l->y - txt->a.ys;
+   s->w = xe - xs;
+   s->h = h;
+   s->stamp = gui->label_cache_clock;
+   n = (UG_U32)s->w * s->h;
+   while ( n-- ) s->px[n] = txt->bc;
+
+   pset = gui->pset;
+   fa = gui->driver[DRIVER_FILL_AREA].state;
+   ff = gui->driver[DRIVER_FILL_FRAME].state;
+   gui->pset = _UG_LabelCachePset;
+   gui->driver[DRIVER_FILL_AREA].state &= ~DRIVER_ENABLED;
+   gui->driver[DRIVER_FILL_FRAME].state &= ~DRIVER_ENABLED;
+   gui->label_capture = s;
+   gui->label_capture_x = xs;
+   gui->label_capture_y = l->y;
+   _UG_PutText( txt );
+   gui->label_capture = NULL;
+   gui->driver[DRIVER_FILL_AREA].state = fa;
+   gui->driver[DRIVER_FILL_FRAME].state = ff;
+   gui->pset = pset;
+
+   _UG_LabelCacheBlit( s, xs, l->y );
+   return 1;
+}
+#endif
+
+void _UG_PutText(UG_TEXT* txt)
+{
+   UG_TEXT_LAYOUT tmp;
+   UG_TEXT_LAYOUT* l;
+   UG_U16 n,max;
+   UG_S16 xp,yp,w;
+   UG_U8 k,e,transparent;
+   UG_U16 chr;
+   char* s;
+   char* end;
+   char* next;
+
+   l = txt->layout;
+   if ( l == NULL )
+   {
+      l = &tmp;
+      l->valid = 0;
+   }
+   if ( !l->valid || (l->str != txt->str) || (l->hash != _UG_HashString( txt->str )) || (l->font_p != txt->font->p) || (l->font_scale != txt->font->scale)
+        || (l->a.xs != txt->a.xs) || (l->a.ys != txt->a.ys) || (l->a.xe != txt->a.xe) || (l->a.ye != txt->a.ye) )
+   {
+      _UG_LayoutText( txt, l );
+   }
+
+#ifdef USE_LABEL_CACHE
+   if ( _UG_LabelCacheDraw( txt, l ) ) return;
+#endif
+
+   transparent = txt->style & TXT_STYLE_TRANSPARENT;
+   max = _UG_TextMaxLines( txt );
+   next = NULL;
+   yp = l->y;
+   for( n=0;n<l->lines;n++ )
+   {
+      if ( n < UG_TEXT_LAYOUT_LINES )
+      {
+         s = txt->str + l->line[n].start;
+         end = s + l->line[n].len;
+         xp = l->line[n].x;
+         e = l->line[n].ellipsis;
+         if ( n == UG_TEXT_LAYOUT_LINES - 1 ) next = txt->str + l->rest;
+      }
+      else
+      {
+         /* Lines beyond the cache are broken and measured on the fly */
+         s = next;
+         end = _UG_BreakLine( txt, s, n == max - 1, &w, &next, &e );
+         xp = _UG_AlignLine( txt, w );
+         if ( xp < 0 ) return;
+         xp += txt->a.xs;
+      }
+
+      if ( _UG_PutTextLine( txt, s, end, e, xp, yp ) )
+      {
+         yp += _UG_GetCharHeight( txt->font ) + txt->v_space;
+         continue;
+      }
+      while ( s < end )
+      {
+         chr = _UG_DecodeChar( &s );
+         w = _UG_GetCharWidth( txt->font, chr );
+         if ( !w ) continue;
+         _UG_PutChar(chr,xp,yp,txt->fc,txt->bc,txt->font,transparent);
+         xp += w + txt->h_space;
+      }
+      if ( e )
+      {
+         w = _UG_GetCharWidth( txt->font, '.' );
+         for( k=0;k<3;k++ )
+         {
+            _UG_PutChar('.',xp,yp,txt->fc,txt->bc,txt->font,transparent);
+            xp += w + txt->h_space;
+         }
+      }
+      yp += _UG_GetCharHeight( txt->font ) + txt->v_space;
+   }
+}
+
+/* Bulk pixel format converters. They work on whole rows without any branches  */
+/* inside the loops, so the compiler is free to vectorize them.                  */
+void _UG_ConvertRGB565ToRGB888( UG_U32* dst, const UG_U16* src, UG_U16 n )
+{
+   UG_U32 c;
+
+   while ( n-- )
+   {
+      c = *src++;
+      *dst++ = ((c & 0xF800) << 8) | ((c & 0x07E0) << 5) | ((c & 0x001F) << 3);
+   }
+}
+
+void _UG_ConvertRGB888ToRGB565( UG_U16* dst, const UG_U32* src, UG_U16 n )
+{
+   UG_U32 c;
+
+   while ( n-- )
+   {
+      c = *src++;
+      *dst++ = (UG_U16)(((c >> 8) & 0xF800) | ((c >> 5) & 0x07E0) | ((c >> 3) & 0x001F));
+   }
+}
+
+void _UG_ConvertByteSwap16( UG_U16* dst, const UG_U16* src, UG_U16 n )
+{
+   UG_U16 c;
+
+   while ( n-- )
+   {
+      c = *src++;
+      *dst++ = (UG_U16)((c << 8) | (c >> 8));
+   }
+}
+
+/* Expands n palette indices with 1, 2, 4 or 8 bits each (MSB first) */
+void _UG_ConvertIndexed( UG_COLOR* dst, const UG_U8* src, UG_U16 n, UG_U8 bpp, const UG_COLOR* pal )
+{
+   UG_U8 b,k,mask;
+
+   if ( bpp == 8 )
+   {
+      while ( n-- )
+      {
+         *dst++ = pal[*src++];
+      }
+      return;
+   }
+
+   mask = (1 << bpp) - 1;
+   while ( n )
+   {
+      b = *src++;
+      for( k=8; k && n; k-=bpp, n-- )
+      {
+         *dst++ = pal[(b >> (k-bpp)) & mask];
+      }
+   }
+}
+
+/* Converts n pixels of 16 or 32 bpp to the native color format. If the source  */
+/* is already stored in the native format, no conversion takes place and the    */
+/* source pointer is returned instead of dst. n must not exceed BMP_CHUNK_SIZE. */
+const UG_COLOR* _UG_ConvertColors( UG_COLOR* dst, const void* src, UG_U16 n, UG_U8 bpp, UG_U8 colors )
+{
+   #ifdef USE_COLOR_RGB888
+   UG_U16 tmp[BMP_CHUNK_SIZE];
+
+   if ( bpp == BMP_BPP_32 ) return (const UG_COLOR*)src;
+
+   if ( colors & BMP_BYTE_SWAP )
+   {
+      _UG_ConvertByteSwap16( tmp, (const UG_U16*)src, n );
+      src = tmp;
+   }
+   _UG_ConvertRGB565ToRGB888( dst, (const UG_U16*)src, n );
+   #endif
+   #ifdef USE_COLOR_RGB565
+   if ( bpp == BMP_BPP_32 )
+   {
+      _UG_ConvertRGB888ToRGB565( dst, (const UG_U32*)src, n );
+   }
+   else if ( colors & BMP_BYTE_SWAP )
+   {
+      _UG_ConvertByteSwap16( dst, (const UG_U16*)src, n );
+   }
+   else
+   {
+      return (const UG_COLOR*)src;
+   }
+   #endif
+   return dst;
+}
+
+/* Converts the palette of an indexed bitmap once into a native lookup table. */
+/* lut holds 16 colors, 8 bpp bitmaps use the table in UG_GUI if there is   */
+/* one. Returns NULL if their pixels have to be converted one by one.       */
+const UG_COLOR* _UG_ConvertPalette( UG_COLOR* lut, const UG_BMP* bmp )
+{
+   UG_U16 i,n,cnt;
+   UG_U8 bpp,bytes;
+   const UG_U8* p;
+   const UG_COLOR* c;
+
+   bpp = ( bmp->colors & BMP_RGB888 )? BMP_BPP_32:BMP_BPP_16;
+   bytes = bpp >> 3;
+   cnt = 1 << bmp->bpp;
+   p = (const UG_U8*)bmp->pal;
+
+   if ( bmp->bpp == BMP_BPP_8 )
+   {
+#ifdef USE_BMP_PALETTE_LUT
+      lut = gui->bmp_lut;
+#else
+      /* A palette in the native format is used as it is */
+      if ( _UG_ConvertColors( lut, p, 1, bpp, bmp->colors ) != lut ) return (const UG_COLOR*)bmp->pal;
+      return NULL;
+#endif
+   }
+
+   for(i=0;i<cnt;i+=n)
+   {
+      n = cnt - i;
+      if ( n > BMP_CHUNK_SIZE ) n = BMP_CHUNK_SIZE;
+      c = _UG_ConvertColors( &lut[i], p, n, bpp, bmp->colors );
+
+      /* Palette is already stored in the native format */
+      if ( c != &lut[i] ) return (const UG_COLOR*)bmp->pal;
+      p += n*bytes;
+   }
+   return lut;
+}
+
+/* Converts n pixels of an 8 bpp bitmap which has no palette table into dst */
+const UG_COLOR* _UG_ConvertIndexed8( UG_COLOR* dst, const UG_U8* src, UG_U16 n, const UG_BMP* bmp )
+{
+   UG_U32 tmp[BMP_CHUNK_SIZE];
+   UG_U16* tmp16;
+   UG_U16 i;
+
+   if ( bmp->colors & BMP_RGB888 )
+   {
+      #ifdef USE_COLOR_RGB888
+      for(i=0;i<n;i++) dst[i] = ((const UG_U32*)bmp->pal)[src[i]];
+      return dst;
+      #else
+      for(i=0;i<n;i++) tmp[i] = ((const UG_U32*)bmp->pal)[src[i]];
+      return _UG_ConvertColors( dst, tmp, n, BMP_BPP_32, bmp->colors );
+      #endif
+   }
+   #ifdef USE_COLOR_RGB565
+   if ( !(bmp->colors & BMP_BYTE_SWAP) )
+   {
+      for(i=0;i<n;i++) dst[i] = ((const UG_U16*)bmp->pal)[src[i]];
+      return dst;
+   }
+   #endif
+   tmp16 = (UG_U16*)tmp;
+   for(i=0;i<n;i++) tmp16[i] = ((const UG_U16*)bmp->pal)[src[i]];
+   return _UG_ConvertColors( dst, tmp16, n, BMP_BPP_16, bmp->colors );
+}
+
+/* Reads one pixel of 8, 16 or 32 bpp from an unaligned byte stream */
+UG_COLOR _UG_ReadBMPPixel( const UG_U8** p, const UG_BMP* bmp, const UG_COLOR* pal )
+{
+   const UG_U8* s = *p;
+   UG_U16 c16;
+   UG_U32 c32;
+   UG_COLOR c;
+
+   if ( bmp->bpp == BMP_BPP_8 )
+   {
+      *p += 1;
+      if ( pal == NULL ) return *_UG_ConvertIndexed8( &c, s, 1, bmp );
+      return pal[s[0]];
+   }
+   if ( bmp->bpp == BMP_BPP_16 )
+   {
+      *p += 2;
+      c16 = (UG_U16)s[0] | ((UG_U16)s[1] << 8);
+      return *_UG_ConvertColors( &c, &c16, 1, BMP_BPP_16, bmp->colors );
+   }
+   *p += 4;
+   c32 = (UG_U32)s[0] | ((UG_U32)s[1] << 8) | ((UG_U32)s[2] << 16) | ((UG_U32)s[3] << 24);
+   return *_UG_ConvertColors( &c, &c32, 1, BMP_BPP_32, bmp->colors );
+}
+
+/* Decodes a compressed bitmap straight to the display. The only state is the */
+/* current run/literal counter (RLE) or the 64 entry color index (QOI).       */
+void _UG_DecodeBMP( UG_S16 xp, UG_S16 yp, const UG_BMP* bmp, const UG_COLOR* pal, void(*push_pixel)(UG_COLOR) )
+{
+   UG_S16 x,y,n;
+   UG_U16 run,lit;
+   UG_U8 b1,b2,r,g,b,a;
+   UG_S8 vg;
+   UG_U32 px;
+   UG_U32 index[64];
+   const UG_U8* p;
+   UG_COLOR c;
+   UG_COLOR buf[BMP_CHUNK_SIZE];
+
+   if ( (bmp->comp == BMP_COMP_RLE) && (bmp->bpp < BMP_BPP_8) ) return;
+   if ( (bmp->comp != BMP_COMP_RLE) && (bmp->comp != BMP_COMP_QOI) ) return;
+
+   for(n=0;n<64;n++) index[n] = 0;
+   p = (const UG_U8*)bmp->p;
+   run = 0;
+   lit = 0;
+   r = g = b = 0;
+   a = 255;
+   c = 0;
+
+   for(y=0;y<bmp->height;y++)
+   {
+      n = 0;
+      for(x=0;x<bmp->width;x++)
+      {
+         if ( run )
+         {
+            /* Repeat the last pixel */
+            run--;
+         }
+         else if ( bmp->comp == BMP_COMP_RLE )
+         {
+            if ( !lit )
+            {
+               b1 = *p++;
+               if ( b1 & 0x80 ) run = b1 & 0x7F;
+               else lit = b1 + 1;
+            }
+            if ( lit ) lit--;
+            c = _UG_ReadBMPPixel( &p, bmp, pal );
+         }
+         else
+         {
+            b1 = *p++;
+            if ( b1 == 0xFE )
+            {
+               r = p[0];
+               g = p[1];
+               b = p[2];
+               p += 3;
+            }
+            else if ( b1 == 0xFF )
+            {
+               r = p[0];
+               g = p[1];
+               b = p[2];
+               a = p[3];
+               p += 4;
+            }
+            else if ( (b1 & 0xC0) == 0x00 )
+            {
+               px = index[b1];
+               a = px >> 24;
+               r = px >> 16;
+               g = px >> 8;
+               b = px;
+            }
+            else if ( (b1 & 0xC0) == 0x40 )
+            {
+               r += ((b1 >> 4) & 0x03) - 2;
+               g += ((b1 >> 2) & 0x03) - 2;
+               b += ( b1       & 0x03) - 2;
+            }
+            else if ( (b1 & 0xC0) == 0x80 )
+            {
+               b2 = *p++;
+               vg = (b1 & 0x3F) - 32;
+               r += vg - 8 + ((b2 >> 4) & 0x0F);
+               g += vg;
+               b += vg - 8 + (b2 & 0x0F);
+            }
+            else
+            {
+               run = b1 & 0x3F;
+            }
+            px = ((UG_U32)a << 24) | ((UG_U32)r << 16) | ((UG_U32)g << 8) | b;
+            index[(r*3 + g*5 + b*7 + a*11) & 0x3F] = px;
+            px &= 0xFFFFFF;
+            c = *_UG_ConvertColors( &c, &px, 1, BMP_BPP_32, BMP_RGB888 );
+         }
+
+         buf[n++] = c;
+         if ( n == BMP_CHUNK_SIZE )
+         {
+            _UG_PushRow( xp+x-n+1, yp+y, buf, n, push_pixel );
+            n = 0;
+         }
+      }
+      if ( n ) _UG_PushRow( xp+x-n, yp+y, buf, n, push_pixel );
+   }
+}
+
+void _UG_PushRow( UG_S16 x, UG_S16 y, const UG_COLOR* p, UG_U16 n, void(*push_pixel)(UG_COLOR) )
+{
+   if ( push_pixel != NULL )
+   {
+      while ( n-- ) push_pixel(*p++);
+   }
+   else
+   {
+      while ( n-- ) gui->pset(x++,y,*p++);
+   }
+}
+
+UG_OBJECT* _UG_GetFreeObject( UG_WINDOW* wnd )
+{
+   UG_U8 i;
+   UG_OBJECT* obj=(UG_OBJECT*)wnd->objlst;
+
+   for(i=0;i<wnd->objcnt;i++)
+   {
+      obj = (UG_OBJECT*)(&wnd->objlst[i]);
+      if ( (obj->state & OBJ_STATE_FREE) && (obj->state & OBJ_STATE_VALID) )
+      {
+         /* Free object found! */
+         return obj;
+      }
+   }
+   return NULL;
+}
+
+UG_OBJECT* _UG_SearchObject( UG_WINDOW* wnd, UG_U8 type, UG_U8 id )
+{
+   UG_U8 i;
+   UG_OBJECT* obj=(UG_OBJECT*)wnd->objlst;
+
+   for(i=0;i<wnd->objcnt;i++)
+   {
+      obj = (UG_OBJECT*)(&wnd->objlst[i]);
+      if ( !(obj->state & OBJ_STATE_FREE) && (obj->state & OBJ_STATE_VALID) )
+      {
+         if ( (obj->type == type) && (obj->id == id) )
+         {
+            /* Requested object found! */
+            return obj;
+         }
+      }
+   }
+   return NULL;
+}
+
+UG_RESULT _UG_DeleteObject( UG_WINDOW* wnd, UG_U8 type, UG_U8 id )
+{
+   UG_OBJECT* obj=NULL;
+
+   obj = _UG_SearchObject( wnd, type, id );
+
+   /* Object found? */
+   if ( obj != NULL )
+   {
+      /* We dont't want to delete a visible or busy object! */
+      if ( (obj->state & OBJ_STATE_VISIBLE) || (obj->state & OBJ_STATE_UPDATE) ) return UG_RESULT_FAIL;
+      obj->state = OBJ_STATE_INIT;
+      obj->data = NULL;
+      obj->event = 0;
+      obj->id = 0;
+      obj->touch_state = 0;
+      obj->type = 0;
+      obj->update = NULL;
+#ifdef USE_UPDATE_BUDGET
+      obj->priority = 0;
+#endif
+      return UG_RESULT_OK;
+   }
+   return UG_RESULT_FAIL;
+}
+
+/* Returns 1 if a pressed object waits for its redraw, it still has to see */
+/* the touch data.                                                          */
+UG_U8 _UG_ProcessTouchData( UG_WINDOW* wnd )
+{
+   UG_S16 xp,yp;
+   UG_U16 i,objcnt;
+   UG_OBJECT* obj;
+   UG_U8 objstate;
+   UG_U8 objtouch;
+   UG_U8 tchstate;
+   UG_U8 pending=0;
+
+   xp = gui->touch.xp;
+   yp = gui->touch.yp;
+   tchstate = gui->touch.state;
+
+   objcnt = wnd->objcnt;
+   for(i=0; i<objcnt; i++)
+   {
+      obj = (UG_OBJECT*)&wnd->objlst[i];
+      objstate = obj->state;
+      objtouch = obj->touch_state;
+      if ( !(objstate & OBJ_STATE_FREE) && (objstate & OBJ_STATE_VALID) && (objstate & OBJ_STATE_VISIBLE) && !(objstate & OBJ_STATE_REDRAW))
+      {
+         /* Process touch data */
+         if ( (tchstate) && xp != -1 )
+         {
+            if ( !(objtouch & OBJ_TOUCH_STATE_IS_PRESSED) )
+            {
+               objtouch |= OBJ_TOUCH_STATE_PRESSED_OUTSIDE_OBJECT | OBJ_TOUCH_STATE_CHANGED;
+               objtouch &= ~(OBJ_TOUCH_STATE_RELEASED_ON_OBJECT | OBJ_TOUCH_STATE_RELEASED_OUTSIDE_OBJECT | OBJ_TOUCH_STATE_CLICK_ON_OBJECT);
+            }
+            objtouch &= ~OBJ_TOUCH_STATE_IS_PRESSED_ON_OBJECT;
+            if ( xp >= obj->a_abs.xs )
+            {
+               if ( xp <= obj->a_abs.xe )
+               {
+                  if ( yp >= obj->a_abs.ys )
+                  {
+                     if ( yp <= obj->a_abs.ye )
+                     {
+                        objtouch |= OBJ_TOUCH_STATE_IS_PRESSED_ON_OBJECT;
+                        if ( !(objtouch & OBJ_TOUCH_STATE_IS_PRESSED) )
+                        {
+                           objtouch &= ~OBJ_TOUCH_STATE_PRESSED_OUTSIDE_OBJECT;
+                           objtouch |= OBJ_TOUCH_STATE_PRESSED_ON_OBJECT;
+                        }
+                     }
+                  }
+               }
+            }
+            objtouch |= OBJ_TOUCH_STATE_IS_PRESSED;
+         }
+         else if ( objtouch & OBJ_TOUCH_STATE_IS_PRESSED )
          {
             if ( objtouch & OBJ_TOUCH_STATE_IS_PRESSED_ON_OBJECT )
             {
@@ -5589,8 +6998,13 @@ void _UG_ProcessTouchData( UG_WINDOW* wnd )
             objtouch &= ~(OBJ_TOUCH_STATE_PRESSED_OUTSIDE_OBJECT | OBJ_TOUCH_STATE_PRESSED_ON_OBJECT | OBJ_TOUCH_STATE_IS_PRESSED);
          }
       }
+      else if ( (objstate & OBJ_STATE_REDRAW) && (objtouch & OBJ_TOUCH_STATE_IS_PRESSED) )
+      {
+         pending = 1;
+      }
       obj->touch_state = objtouch;
    }
+   return pending;
 }
 
 void _UG_UpdateObjects( UG_WINDOW* wnd )
@@ -5600,6 +7014,14 @@ void _UG_UpdateObjects( UG_WINDOW* wnd )
    UG_U8 objstate;
    UG_U8 objtouch;
 
+#ifdef USE_UPDATE_BUDGET
+   if ( (gui->clock != NULL) && gui->update_budget )
+   {
+      _UG_UpdateObjectsBudget( wnd );
+      return;
+   }
+#endif
+
    /* Check each object, if it needs to be updated? */
    objcnt = wnd->objcnt;
    for(i=0; i<objcnt; i++)
@@ -5611,19 +7033,89 @@ void _UG_UpdateObjects( UG_WINDOW* wnd )
       {
          if ( objstate & OBJ_STATE_UPDATE )
          {
+            _UG_TRACE_BEGIN( TRACE_OBJECT, obj->type, obj->id );
             obj->update(wnd,obj);
+            _UG_TRACE_END( TRACE_OBJECT, obj->type, obj->id );
+            _UG_STAT_ADD( objects, 1 );
          }
          if ( (objstate & OBJ_STATE_VISIBLE) && (objstate & OBJ_STATE_TOUCH_ENABLE) )
          {
             if ( (objtouch & (OBJ_TOUCH_STATE_CHANGED | OBJ_TOUCH_STATE_IS_PRESSED)) )
             {
+               _UG_TRACE_BEGIN( TRACE_OBJECT, obj->type, obj->id );
                obj->update(wnd,obj);
+               _UG_TRACE_END( TRACE_OBJECT, obj->type, obj->id );
+               _UG_STAT_ADD( objects, 1 );
             }
          }
       }
    }
 }
 
+#ifdef USE_UPDATE_BUDGET
+/* Updates the objects which are touched first, so input is handled in every */
+/* call. The pending redraws follow by priority (in list order within one)   */
+/* until the budget of this UG_Update() is used up, at least one of them is  */
+/* drawn per call. The others keep OBJ_STATE_UPDATE for the next call.      */
+void _UG_UpdateObjectsBudget( UG_WINDOW* wnd )
+{
+   UG_U16 i,objcnt,n,lp,bp;
+   UG_S16 li,best;
+   UG_OBJECT* obj;
+   UG_U8 objstate;
+
+   objcnt = wnd->objcnt;
+   for(i=0; i<objcnt; i++)
+   {
+      obj = (UG_OBJECT*)&wnd->objlst[i];
+      objstate = obj->state;
+      if ( !(objstate & OBJ_STATE_FREE) && (objstate & OBJ_STATE_VALID) && (objstate & OBJ_STATE_VISIBLE) && (objstate & OBJ_STATE_TOUCH_ENABLE) )
+      {
+         if ( obj->touch_state & (OBJ_TOUCH_STATE_CHANGED | OBJ_TOUCH_STATE_IS_PRESSED) )
+         {
+            _UG_TRACE_BEGIN( TRACE_OBJECT, obj->type, obj->id );
+            obj->update(wnd,obj);
+            _UG_TRACE_END( TRACE_OBJECT, obj->type, obj->id );
+            _UG_STAT_ADD( objects, 1 );
+         }
+      }
+   }
+
+   /* Every pending object is visited once: the last one was lp/li */
+   lp = 0x100;
+   li = -1;
+   n = 0;
+   while ( 1 )
+   {
+      best = -1;
+      bp = 0;
+      for(i=0; i<objcnt; i++)
+      {
+         obj = (UG_OBJECT*)&wnd->objlst[i];
+         objstate = obj->state;
+         if ( (objstate & OBJ_STATE_FREE) || !(objstate & OBJ_STATE_VALID) || !(objstate & OBJ_STATE_UPDATE) ) continue;
+         if ( (obj->priority > lp) || ((obj->priority == lp) && ((UG_S16)i <= li)) ) continue;
+         if ( (best < 0) || (obj->priority > bp) )
+         {
+            best = i;
+            bp = obj->priority;
+         }
+      }
+      if ( best < 0 ) break;
+      if ( n && ((UG_U32)(gui->clock() - gui->update_start) >= gui->update_budget) ) break;
+
+      obj = (UG_OBJECT*)&wnd->objlst[best];
+      _UG_TRACE_BEGIN( TRACE_OBJECT, obj->type, obj->id );
+      obj->update(wnd,obj);
+      _UG_TRACE_END( TRACE_OBJECT, obj->type, obj->id );
+      _UG_STAT_ADD( objects, 1 );
+      n++;
+      lp = bp;
+      li = best;
+   }
+}
+#endif
+
 void _UG_HandleEvents( UG_WINDOW* wnd )
 {
    UG_U16 i,objcnt;
@@ -5652,7 +7144,9 @@ void _UG_HandleEvents( UG_WINDOW* wnd )
             msg.sub_id = obj->id;
             msg.event = obj->event;
 
+            _UG_TRACE_BEGIN( TRACE_EVENT, obj->type, obj->id );
             wnd->cb( &msg );
+            _UG_TRACE_END( TRACE_EVENT, obj->type, obj->id );
 
             obj->event = OBJ_EVENT_NONE;
          }
@@ -5689,7 +7183,9 @@ void _UG_SendObjectPrerenderEvent(UG_WINDOW *wnd,UG_OBJECT *obj)
 	msg.sub_id = obj->id;
 	msg.src = obj;
 
+	_UG_TRACE_BEGIN( TRACE_EVENT, obj->type, obj->id );
 	wnd->cb(&msg);
+	_UG_TRACE_END( TRACE_EVENT, obj->type, obj->id );
 }
 #endif
 
@@ -5703,7 +7199,9 @@ void _UG_SendObjectPostrenderEvent(UG_WINDOW *wnd,UG_OBJECT *obj)
 	msg.sub_id = obj->id;
 	msg.src = obj;
 
+	_UG_TRACE_BEGIN( TRACE_EVENT, obj->type, obj->id );
 	wnd->cb(&msg);
+	_UG_TRACE_END( TRACE_EVENT, obj->type, obj->id );
 }
 #endif
 
@@ -5746,6 +7244,25 @@ void UG_Update( void )
    /* Is somebody waiting for this update? */
    if ( gui->state & UG_SATUS_WAIT_FOR_UPDATE ) gui->state &= ~UG_SATUS_WAIT_FOR_UPDATE;
 
+#ifdef USE_CLOCK
+   if ( gui->clock != NULL ) gui->update_start = gui->clock();
+#endif
+#ifdef USE_STATS
+   gui->stats_lap = gui->update_start;
+   gui->stats.updates++;
+#endif
+   _UG_TRACE_BEGIN( TRACE_UPDATE, 0, 0 );
+
+#ifdef USE_TIMER
+   /* Run the timers and tweens which are due */
+   if ( gui->clock != NULL ) _UG_UpdateTimers( gui->update_start );
+#endif
+
+#ifdef USE_BINDING
+   /* Show the current values of bound variables */
+   _UG_UpdateBindings();
+#endif
+
    /* Keep track of the windows */
    if ( gui->next_window != gui->active_window )
    {
@@ -5766,6 +7283,7 @@ void UG_Update( void )
          }
          gui->active_window->state &= ~WND_STATE_REDRAW_TITLE;
          gui->active_window->state |= WND_STATE_UPDATE | WND_STATE_VISIBLE;
+         gui->touch.pending = 1;
       }
    }
 
@@ -5778,18 +7296,106 @@ void UG_Update( void )
       if ( wnd->state & WND_STATE_UPDATE )
       {
          /* Do it! */
+         _UG_TRACE_BEGIN( TRACE_WINDOW, 0, 0 );
          _UG_WindowUpdate( wnd );
+         _UG_TRACE_END( TRACE_WINDOW, 0, 0 );
       }
 
       /* Is the window visible? */
       if ( wnd->state & WND_STATE_VISIBLE )
       {
-         _UG_ProcessTouchData( wnd );
+         _UG_STAT_TIME( time_update );
+         /* A released touch only has to be processed once */
+         if ( gui->touch.pending || (gui->touch.state == TOUCH_STATE_PRESSED) )
+         {
+            gui->touch.pending = 0;
+            if ( _UG_ProcessTouchData( wnd ) ) gui->touch.pending = 1;
+         }
+         _UG_STAT_TIME( time_touch );
          _UG_UpdateObjects( wnd );
+         _UG_STAT_TIME( time_update );
          _UG_HandleEvents( wnd );
+         _UG_STAT_TIME( time_events );
       }
    }
+   _UG_TRACE_END( TRACE_UPDATE, 0, 0 );
+}
+
+#ifdef USE_CLOCK
+/* clock returns a free running time in any unit, the delays, periods and */
+/* durations of timers and tweens and the update budget are given in the  */
+/* same unit.                                                             */
+void UG_SetClock( UG_U32 (*clock)( void ) )
+{
+   gui->clock = clock;
+}
+#endif
+
+#ifdef USE_STATS
+/* Copies the counters and starts counting again */
+void UG_GetStats( UG_STATS* stats )
+{
+   if ( stats != NULL ) *stats = gui->stats;
+   _UG_StatsClear( &gui->stats );
+}
+
+void _UG_StatsClear( UG_STATS* stats )
+{
+   UG_U8 i;
+
+   stats->updates = 0;
+   stats->psets = 0;
+   stats->push_bytes = 0;
+   for(i=0;i<NUMBER_OF_DRIVERS;i++) stats->driver_calls[i] = 0;
+   stats->fill_pixels = 0;
+   stats->line_pixels = 0;
+   stats->bmp_pixels = 0;
+   stats->glyphs = 0;
+   stats->glyph_pixels = 0;
+   stats->objects = 0;
+   stats->time_touch = 0;
+   stats->time_update = 0;
+   stats->time_events = 0;
+}
+
+void _UG_StatsPset( UG_S16 x, UG_S16 y, UG_COLOR c )
+{
+   gui->stats.psets++;
+   gui->stats_pset( x, y, c );
+}
+
+/* Time since the last lap */
+UG_U32 _UG_StatsLap( void )
+{
+   UG_U32 t,d;
+
+   if ( gui->clock == NULL ) return 0;
+   t = gui->clock();
+   d = t - gui->stats_lap;
+   gui->stats_lap = t;
+   return d;
+}
+#endif
+
+#ifdef USE_UPDATE_BUDGET
+/* budget is given in the unit of the clock set with UG_SetClock. A budget */
+/* of 0 (or no clock) lets UG_Update() draw everything.                     */
+void UG_SetUpdateBudget( UG_U32 budget )
+{
+   gui->update_budget = budget;
+}
+
+UG_RESULT UG_ObjectSetPriority( UG_WINDOW* wnd, UG_U8 type, UG_U8 id, UG_U8 priority )
+{
+   UG_OBJECT* obj=NULL;
+
+   obj = _UG_SearchObject( wnd, type, id );
+   if ( obj == NULL ) return UG_RESULT_FAIL;
+   obj->priority = priority;
+
+   return UG_RESULT_OK;
 }
+#endif
 
 void UG_WaitForUpdate( void )
 {
@@ -5804,50 +7410,446 @@ void UG_WaitForUpdate( void )
 
 void UG_DrawBMP( UG_S16 xp, UG_S16 yp, UG_BMP* bmp )
 {
-   UG_S16 x,y,xs;
-   UG_U8 r,g,b;
-   UG_U16* p;
-   UG_U16 tmp;
-   UG_COLOR c;
+   UG_S16 x,y,n;
+   UG_U32 stride;
+   const UG_U8* p;
+   const UG_COLOR* row;
+   const UG_COLOR* pal;
+   UG_COLOR buf[BMP_CHUNK_SIZE];
+   UG_COLOR lut[16];
+   void(*push_pixel)(UG_COLOR);
 
    if ( bmp->p == NULL ) return;
 
-   /* Only support 16 BPP so far */
-   if ( bmp->bpp == BMP_BPP_16 )
+   /* Indexed bitmaps need a palette */
+   pal = NULL;
+   switch ( bmp->bpp )
+   {
+      case BMP_BPP_1:
+      case BMP_BPP_2:
+      case BMP_BPP_4:
+      case BMP_BPP_8:
+      {
+         if ( bmp->pal == NULL ) return;
+         pal = _UG_ConvertPalette( lut, bmp );
+         break;
+      }
+      case BMP_BPP_16:
+      case BMP_BPP_32:
+         break;
+      default:
+         return;
+   }
+
+   _UG_STAT_ADD( bmp_pixels, (UG_U32)bmp->width*bmp->height );
+
+   /* Is hardware acceleration available? */
+   push_pixel = NULL;
+   if ( gui->driver[DRIVER_FILL_AREA].state & DRIVER_ENABLED )
    {
-      p = (UG_U16*)bmp->p;
+      _UG_TRACE_BEGIN( TRACE_DRIVER, DRIVER_FILL_AREA, 0 );
+      push_pixel = ((void*(*)(UG_S16, UG_S16, UG_S16, UG_S16))gui->driver[DRIVER_FILL_AREA].driver)(xp,yp,xp+bmp->width-1,yp+bmp->height-1);
+      _UG_TRACE_END( TRACE_DRIVER, DRIVER_FILL_AREA, 0 );
+      _UG_STAT_ADD( driver_calls[DRIVER_FILL_AREA], 1 );
+      _UG_STAT_ADD( push_bytes, (UG_U32)bmp->width*bmp->height*sizeof(UG_COLOR) );
    }
-   else
+
+   /* Compressed bitmaps are decoded in a single pass */
+   if ( bmp->comp != BMP_COMP_NONE )
    {
+      _UG_DecodeBMP( xp, yp, bmp, pal, push_pixel );
       return;
    }
 
-   xs = xp;
+   stride = ((UG_U32)bmp->width * bmp->bpp + 7) >> 3;
+
    for(y=0;y<bmp->height;y++)
    {
-      xp = xs;
-      for(x=0;x<bmp->width;x++)
+      for(x=0;x<bmp->width;x+=n)
+      {
+         n = bmp->width - x;
+         if ( n > BMP_CHUNK_SIZE ) n = BMP_CHUNK_SIZE;
+
+         /* Chunks always start at a byte boundary */
+         p = (const UG_U8*)bmp->p + y*stride + (((UG_U32)x * bmp->bpp) >> 3);
+         if ( pal != NULL )
+         {
+            _UG_ConvertIndexed( buf, p, n, bmp->bpp, pal );
+            row = buf;
+         }
+         else if ( bmp->bpp == BMP_BPP_8 )
+         {
+            row = _UG_ConvertIndexed8( buf, p, n, bmp );
+         }
+         else
+         {
+            row = _UG_ConvertColors( buf, p, n, bmp->bpp, bmp->colors );
+         }
+         _UG_PushRow( xp+x, yp+y, row, n, push_pixel );
+      }
+   }
+}
+
+#ifdef USE_ASSET_PACK
+UG_RESULT UG_PackOpen( UG_PACK* pack, const void* data, UG_U32 size )
+{
+   const UG_PACK_HEADER* h = (const UG_PACK_HEADER*)data;
+
+   if ( (data == NULL) || ((uintptr_t)data & 3) ) return UG_RESULT_FAIL;
+   if ( size < sizeof(UG_PACK_HEADER) ) return UG_RESULT_FAIL;
+   if ( (h->magic != PACK_MAGIC) || (h->version != PACK_VERSION) ) return UG_RESULT_FAIL;
+   if ( h->size > size ) return UG_RESULT_FAIL;
+   if ( sizeof(UG_PACK_HEADER) + (UG_U32)h->count * sizeof(UG_PACK_ENTRY) > h->size ) return UG_RESULT_FAIL;
+
+   pack->data = (const UG_U8*)data;
+   pack->size = h->size;
+   pack->count = h->count;
+   pack->index = (const UG_PACK_ENTRY*)(pack->data + sizeof(UG_PACK_HEADER));
+   return UG_RESULT_OK;
+}
+
+/* Returns the index entry of an asset or NULL if the pack doesn't contain it */
+const UG_PACK_ENTRY* _UG_PackFind( const UG_PACK* pack, const char* name, UG_U16 type, UG_U32 record_size )
+{
+   const UG_PACK_ENTRY* e;
+   UG_U16 i,j;
+
+   for(i=0;i<pack->count;i++)
+   {
+      e = &pack->index[i];
+      if ( e->type != type ) continue;
+      for(j=0;(j<PACK_NAME_LENGTH) && name[j] && (e->name[j] == name[j]);j++);
+      if ( j < PACK_NAME_LENGTH )
+      {
+         if ( e->name[j] != name[j] ) continue;
+      }
+      else if ( name[j] != 0 ) continue;
+
+      if ( (e->offset & 3) || (e->size < record_size) ) return NULL;
+      if ( (e->offset > pack->size) || (e->size > pack->size - e->offset) ) return NULL;
+      return e;
+   }
+   return NULL;
+}
+
+/* Checks that an array of count elements of size bytes lies inside of an */
+/* asset and is aligned                                                    */
+UG_U8 _UG_PackCheck( const UG_PACK_ENTRY* e, UG_U32 offset, UG_U32 count, UG_U32 size, UG_U32 align )
+{
+   if ( offset & (align - 1) ) return 0;
+   if ( (offset < e->offset) || (offset - e->offset > e->size) ) return 0;
+   return !size || (count <= (e->size - (offset - e->offset)) / size);
+}
+
+/* Checks that a FONT_TYPE_1BPP_RLE glyph of w x h pixels is decoded from */
+/* its n bytes. It follows the nibbles the same way _UG_PutCharRLE does.  */
+UG_U8 _UG_PackCheckRLE( const UG_U8* p, UG_U32 n, UG_U16 w, UG_U16 h )
+{
+   UG_U32 ni;
+   UG_U16 j,xo,run,rep;
+   UG_U8 v,first;
+
+   ni = 0;
+   j = 0;
+   while ( j < h )
+   {
+      if ( (ni >> 1) >= n ) return 0;
+      rep = (p[ni>>1] >> ((ni & 1) ? 0:4)) & 0x0F;
+      ni++;
+      if ( rep >= h - j ) rep = h - j - 1;
+
+      xo = 0;
+      run = 0;
+      first = 1;
+      while ( xo < w )
+      {
+         if ( (ni >> 1) >= n ) return 0;
+         v = (p[ni>>1] >> ((ni & 1) ? 0:4)) & 0x0F;
+         ni++;
+         run += v;
+         if ( v == 15 ) continue;
+         if ( !run )
+         {
+            if ( first )
+            {
+               first = 0;
+               continue;
+            }
+            run = w - xo;
+         }
+         if ( run > w - xo ) return 1;
+         xo += run;
+         run = 0;
+         first = 0;
+      }
+      j += rep + 1;
+   }
+   return 1;
+}
+
+/* Checks that a compressed bitmap is decoded from its n bytes. Only the */
+/* packet headers are followed, the pixels aren't decoded.              */
+UG_U8 _UG_PackCheckStream( const UG_U8* p, UG_U32 n, const UG_PACK_BMP* b )
+{
+   UG_U32 i,k,c,px;
+   UG_U8 h;
+
+   px = (UG_U32)b->width * b->height;
+   i = 0;
+   while ( px )
+   {
+      if ( i >= n ) return 0;
+      h = p[i++];
+      if ( b->comp == BMP_COMP_RLE )
+      {
+         /* A run reads one pixel, a literal one per covered pixel */
+         c = ( h & 0x80 ) ? (h & 0x7F) + 1 : h + 1;
+         if ( c > px ) c = px;
+         k = ( h & 0x80 ) ? 1 : c;
+         k *= b->bpp >> 3;
+      }
+      else
+      {
+         c = ( ((h & 0xC0) == 0xC0) && (h < 0xFE) ) ? (h & 0x3F) + 1 : 1;
+         if ( c > px ) c = px;
+         if ( h == 0xFE ) k = 3;
+         else if ( h == 0xFF ) k = 4;
+         else k = ( (h & 0xC0) == 0x80 ) ? 1 : 0;
+      }
+      if ( k > n - i ) return 0;
+      i += k;
+      px -= c;
+   }
+   return 1;
+}
+
+/* All arrays of a font are checked against the size of its asset, their */
+/* lengths follow from the record. Glyphs have to fit between offsets.   */
+UG_RESULT UG_PackGetFont( const UG_PACK* pack, const char* name, UG_FONT* font )
+{
+   const UG_PACK_ENTRY* e;
+   const UG_PACK_FONT* f;
+   const UG_FONT_RANGE* r;
+   const UG_U32* o;
+   UG_FONT ft;
+   UG_U32 n,g,size;
+   UG_U16 w;
+
+   e = _UG_PackFind( pack, name, PACK_TYPE_FONT, sizeof(UG_PACK_FONT) );
+   if ( e == NULL ) return UG_RESULT_FAIL;
+   f = (const UG_PACK_FONT*)(pack->data + e->offset);
+   if ( f->font_type > FONT_TYPE_2BPP ) return UG_RESULT_FAIL;
+   if ( (f->char_width > 0x7FFF) || (f->char_height > 0x7FFF) ) return UG_RESULT_FAIL;
+
+   /* The font points straight into the pack */
+   ft.p = (unsigned char*)(pack->data + f->data);
+   ft.font_type = (FONT_TYPE)f->font_type;
+   ft.char_width = f->char_width;
+   ft.char_height = f->char_height;
+   ft.start_char = f->start_char;
+   ft.end_char = f->end_char;
+   ft.widths = f->widths ? (UG_U8*)(pack->data + f->widths) : NULL;
+   ft.offsets = f->offsets ? (const UG_U32*)(pack->data + f->offsets) : NULL;
+   ft.ranges = f->ranges ? (const UG_FONT_RANGE*)(pack->data + f->ranges) : NULL;
+   ft.range_count = f->ranges ? f->range_count : 0;
+   ft.read = NULL;
+   ft.bboxes = NULL;
+   ft.scale = 1;
+
+   /* Number of glyphs */
+   if ( ft.ranges != NULL )
+   {
+      if ( !_UG_PackCheck( e, f->ranges, ft.range_count, sizeof(UG_FONT_RANGE), 2 ) ) return UG_RESULT_FAIL;
+      n = 0;
+      for(g=0;g<ft.range_count;g++)
+      {
+         r = &ft.ranges[g];
+         if ( r->first > r->last ) return UG_RESULT_FAIL;
+         if ( (UG_U32)r->glyph + (r->last - r->first) + 1 > n ) n = (UG_U32)r->glyph + (r->last - r->first) + 1;
+      }
+   }
+   else
+   {
+      if ( ft.end_char < ft.start_char ) return UG_RESULT_FAIL;
+      n = ft.end_char - ft.start_char + 1;
+   }
+
+   if ( ft.widths != NULL )
+   {
+      if ( !_UG_PackCheck( e, f->widths, n, 1, 1 ) ) return UG_RESULT_FAIL;
+      for(g=0;g<n;g++) if ( ft.widths[g] > ft.char_width ) return UG_RESULT_FAIL;
+   }
+
+   if ( ft.offsets == NULL )
+   {
+      /* Dense glyphs of one size, RLE glyphs always have offsets */
+      if ( ft.font_type == FONT_TYPE_1BPP_RLE ) return UG_RESULT_FAIL;
+      if ( !_UG_PackCheck( e, f->data, n, _UG_GetGlyphSize( &ft ), 1 ) ) return UG_RESULT_FAIL;
+   }
+   else
+   {
+      if ( !_UG_PackCheck( e, f->offsets, n + 1, 4, 4 ) ) return UG_RESULT_FAIL;
+      o = ft.offsets;
+      if ( !_UG_PackCheck( e, f->data, o[n], 1, 1 ) ) return UG_RESULT_FAIL;
+      for(g=0;g<n;g++)
       {
-         tmp = *p++;
-         /* Convert RGB565 to RGB888 */
-         r = (tmp>>11)&0x1F;
-         r<<=3;
-         g = (tmp>>5)&0x3F;
-         g<<=2;
-         b = (tmp)&0x1F;
-         b<<=3;
-         c = ((UG_COLOR)r<<16) | ((UG_COLOR)g<<8) | (UG_COLOR)b;
-         UG_DrawPixel( xp++ , yp , c );
+         if ( (o[g] > o[g+1]) || (o[g+1] > o[n]) ) return UG_RESULT_FAIL;
+         w = ft.widths ? ft.widths[g] : ft.char_width;
+         if ( ft.font_type == FONT_TYPE_1BPP_RLE )
+         {
+            if ( !_UG_PackCheckRLE( &ft.p[o[g]], o[g+1] - o[g], w, ft.char_height ) ) return UG_RESULT_FAIL;
+            continue;
+         }
+         size = _UG_GetGlyphSize( &ft );
+         if ( ft.font_type == FONT_TYPE_4BPP ) size = (UG_U32)ft.char_height * ((w * 4 + 7) >> 3);
+         if ( ft.font_type == FONT_TYPE_2BPP ) size = (UG_U32)ft.char_height * ((w * 2 + 7) >> 3);
+         if ( size > o[g+1] - o[g] ) return UG_RESULT_FAIL;
       }
-      yp++;
    }
+
+   *font = ft;
+   return UG_RESULT_OK;
+}
+
+UG_RESULT UG_PackGetBMP( const UG_PACK* pack, const char* name, UG_BMP* bmp )
+{
+   const UG_PACK_ENTRY* e;
+   const UG_PACK_BMP* b;
+   UG_U32 stride,bytes;
+
+   e = _UG_PackFind( pack, name, PACK_TYPE_BMP, sizeof(UG_PACK_BMP) );
+   if ( e == NULL ) return UG_RESULT_FAIL;
+   b = (const UG_PACK_BMP*)(pack->data + e->offset);
+   if ( !_UG_PackCheck( e, b->data, 0, 0, 1 ) ) return UG_RESULT_FAIL;
+
+   /* Indexed bitmaps read 2^bpp palette entries */
+   if ( b->pal && (b->bpp <= BMP_BPP_8) )
+   {
+      bytes = ( b->colors & BMP_RGB888 ) ? 4:2;
+      if ( !_UG_PackCheck( e, b->pal, (UG_U32)1 << b->bpp, bytes, bytes ) ) return UG_RESULT_FAIL;
+   }
+
+   if ( b->comp == BMP_COMP_NONE )
+   {
+      /* 16 and 32 bpp rows are read in place as UG_U16 and UG_COLOR */
+      stride = ((UG_U32)b->width * b->bpp + 7) >> 3;
+      if ( !_UG_PackCheck( e, b->data, b->height, stride, b->bpp >= BMP_BPP_16 ? b->bpp >> 3 : 1 ) ) return UG_RESULT_FAIL;
+   }
+   else if ( ((b->comp == BMP_COMP_RLE) && (b->bpp >= BMP_BPP_8)) || (b->comp == BMP_COMP_QOI) )
+   {
+      if ( !_UG_PackCheckStream( pack->data + b->data, e->offset + e->size - b->data, b ) ) return UG_RESULT_FAIL;
+   }
+
+   bmp->p = (void*)(pack->data + b->data);
+   bmp->width = b->width;
+   bmp->height = b->height;
+   bmp->bpp = b->bpp;
+   bmp->colors = b->colors;
+   bmp->pal = b->pal ? (const void*)(pack->data + b->pal) : NULL;
+   bmp->comp = b->comp;
+   return UG_RESULT_OK;
+}
+
+UG_RESULT UG_PackGetPalette( const UG_PACK* pack, const char* name, const void** pal, UG_U16* count, UG_U8* colors )
+{
+   const UG_PACK_ENTRY* e;
+   const UG_PACK_PALETTE* p;
+   UG_U32 bytes;
+
+   e = _UG_PackFind( pack, name, PACK_TYPE_PALETTE, sizeof(UG_PACK_PALETTE) );
+   if ( e == NULL ) return UG_RESULT_FAIL;
+   p = (const UG_PACK_PALETTE*)(pack->data + e->offset);
+   bytes = ( p->colors & BMP_RGB888 ) ? 4:2;
+   if ( !_UG_PackCheck( e, p->data, p->count, bytes, 2 ) ) return UG_RESULT_FAIL;
+
+   *pal = (const void*)(pack->data + p->data);
+   if ( count != NULL ) *count = p->count;
+   if ( colors != NULL ) *colors = p->colors;
+   return UG_RESULT_OK;
 }
+#endif
 
 void UG_TouchUpdate( UG_S16 xp, UG_S16 yp, UG_U8 state )
 {
    gui->touch.xp = xp;
    gui->touch.yp = yp;
    gui->touch.state = state;
+   gui->touch.pending = 1;
+}
+
+/* Returns 1 if UG_Update() has nothing to do until new touch data, a change */
+/* of the GUI or the next deadline of the timers (UG_GetNextDeadline).      */
+/* Bound values are formatted and compared, a changed one isn't idle.       */
+UG_U8 UG_IsIdle( void )
+{
+   UG_WINDOW* wnd;
+   UG_OBJECT* obj;
+   UG_U16 i;
+
+   if ( gui->state & UG_SATUS_WAIT_FOR_UPDATE ) return 0;
+#ifdef USE_BINDING
+   if ( _UG_BindingsChanged() ) return 0;
+#endif
+   if ( (gui->next_window != NULL) && (gui->next_window != gui->active_window) ) return 0;
+   wnd = gui->active_window;
+   if ( wnd == NULL ) return 1;
+   if ( wnd->state & WND_STATE_UPDATE ) return 0;
+   if ( !(wnd->state & WND_STATE_VISIBLE) ) return 1;
+   if ( gui->touch.pending ) return 0;
+
+   for(i=0; i<wnd->objcnt; i++)
+   {
+      obj = (UG_OBJECT*)&wnd->objlst[i];
+      if ( (obj->state & OBJ_STATE_FREE) || !(obj->state & OBJ_STATE_VALID) ) continue;
+      if ( obj->state & OBJ_STATE_UPDATE ) return 0;
+      if ( obj->event != OBJ_EVENT_NONE ) return 0;
+      if ( (obj->state & OBJ_STATE_TOUCH_ENABLE) && (obj->touch_state & OBJ_TOUCH_STATE_CHANGED) ) return 0;
+   }
+   return 1;
+}
+
+/* Formats a fixed-point number with the given number of decimals (1234 with */
+/* 2 decimals is "12.34"), right aligned to at least width characters.       */
+/* Returns the length of the string or 0 if it doesn't fit into size bytes. */
+UG_U8 UG_FormatNumber( char* str, UG_U8 size, UG_S32 value, UG_U8 width, UG_U8 decimals, UG_U8 flags )
+{
+   char buf[24];
+   UG_U32 u;
+   UG_U8 i,n,len;
+   char sign;
+
+   if ( (str == NULL) || !size ) return 0;
+   str[0] = 0;
+   if ( decimals > 10 ) return 0;
+
+   sign = 0;
+   if ( value < 0 ) sign = '-';
+   else if ( flags & NUM_SIGN_PLUS ) sign = '+';
+   u = ( value < 0 ) ? 0 - (UG_U32)value : (UG_U32)value;
+
+   /* Digits in reverse order, at least one in front of the point */
+   n = 0;
+   do
+   {
+      if ( decimals && (n == decimals) ) buf[n++] = '.';
+      buf[n++] = '0' + u % 10;
+      u /= 10;
+   } while ( u || (n <= decimals) );
+
+   len = n + ( sign ? 1:0 );
+   if ( len < width ) len = width;
+   if ( len >= size ) return 0;
+
+   i = 0;
+   if ( !(flags & NUM_PAD_ZERO) )
+   {
+      while ( i < len - n - ( sign ? 1:0 ) ) str[i++] = ' ';
+   }
+   if ( sign ) str[i++] = sign;
+   while ( i < len - n ) str[i++] = '0';
+   while ( n ) str[i++] = buf[--n];
+   str[i] = 0;
+   return len;
 }
 
 /* -------------------------------------------------------------------------------- */
@@ -5866,6 +7868,9 @@ UG_RESULT UG_WindowCreate( UG_WINDOW* wnd, UG_OBJECT* objlst, UG_U8 objcnt, void
       obj = (UG_OBJECT*)&objlst[i];
       obj->state = OBJ_STATE_INIT;
       obj->data = NULL;
+#ifdef USE_UPDATE_BUDGET
+      obj->priority = 0;
+#endif
    }
 
    /* Initialize window */
@@ -5889,6 +7894,7 @@ UG_RESULT UG_WindowCreate( UG_WINDOW* wnd, UG_OBJECT* objlst, UG_U8 objcnt, void
 
    /* Initialize window title-bar */
    wnd->title.str = NULL;
+   wnd->title.str_hash = 0;
    if (gui != NULL) wnd->title.font = &gui->font;
    else wnd->title.font = NULL;
    wnd->title.h_space = 2;
@@ -5899,6 +7905,7 @@ UG_RESULT UG_WindowCreate( UG_WINDOW* wnd, UG_OBJECT* objlst, UG_U8 objcnt, void
    wnd->title.ifc = C_WHITE;
    wnd->title.ibc = C_GRAY;
    wnd->title.height = 15;
+   wnd->title.layout.valid = 0;
 
    return UG_RESULT_OK;
 }
@@ -6022,6 +8029,7 @@ UG_RESULT UG_WindowSetForeColor( UG_WINDOW* wnd, UG_COLOR fc )
 {
    if ( (wnd != NULL) && (wnd->state & WND_STATE_VALID) )
    {
+      if ( wnd->fc == fc ) return UG_RESULT_OK;
       wnd->fc = fc;
       wnd->state |= WND_STATE_UPDATE;
       return UG_RESULT_OK;
@@ -6033,6 +8041,7 @@ UG_RESULT UG_WindowSetBackColor( UG_WINDOW* wnd, UG_COLOR bc )
 {
    if ( (wnd != NULL) && (wnd->state & WND_STATE_VALID) )
    {
+      if ( wnd->bc == bc ) return UG_RESULT_OK;
       wnd->bc = bc;
       wnd->state |= WND_STATE_UPDATE;
       return UG_RESULT_OK;
@@ -6044,6 +8053,7 @@ UG_RESULT UG_WindowSetTitleTextColor( UG_WINDOW* wnd, UG_COLOR c )
 {
    if ( (wnd != NULL) && (wnd->state & WND_STATE_VALID) )
    {
+      if ( wnd->title.fc == c ) return UG_RESULT_OK;
       wnd->title.fc = c;
       wnd->state |= WND_STATE_UPDATE | WND_STATE_REDRAW_TITLE;
       return UG_RESULT_OK;
@@ -6055,6 +8065,7 @@ UG_RESULT UG_WindowSetTitleColor( UG_WINDOW* wnd, UG_COLOR c )
 {
    if ( (wnd != NULL) && (wnd->state & WND_STATE_VALID) )
    {
+      if ( wnd->title.bc == c ) return UG_RESULT_OK;
       wnd->title.bc = c;
       wnd->state |= WND_STATE_UPDATE | WND_STATE_REDRAW_TITLE;
       return UG_RESULT_OK;
@@ -6066,6 +8077,7 @@ UG_RESULT UG_WindowSetTitleInactiveTextColor( UG_WINDOW* wnd, UG_COLOR c )
 {
    if ( (wnd != NULL) && (wnd->state & WND_STATE_VALID) )
    {
+      if ( wnd->title.ifc == c ) return UG_RESULT_OK;
       wnd->title.ifc = c;
       wnd->state |= WND_STATE_UPDATE | WND_STATE_REDRAW_TITLE;
       return UG_RESULT_OK;
@@ -6077,6 +8089,7 @@ UG_RESULT UG_WindowSetTitleInactiveColor( UG_WINDOW* wnd, UG_COLOR c )
 {
    if ( (wnd != NULL) && (wnd->state & WND_STATE_VALID) )
    {
+      if ( wnd->title.ibc == c ) return UG_RESULT_OK;
       wnd->title.ibc = c;
       wnd->state |= WND_STATE_UPDATE | WND_STATE_REDRAW_TITLE;
       return UG_RESULT_OK;
@@ -6086,9 +8099,16 @@ UG_RESULT UG_WindowSetTitleInactiveColor( UG_WINDOW* wnd, UG_COLOR c )
 
 UG_RESULT UG_WindowSetTitleText( UG_WINDOW* wnd, char* str )
 {
+   UG_U32 hash;
+
    if ( (wnd != NULL) && (wnd->state & WND_STATE_VALID) )
    {
+      /* The same buffer may be set again with a new content */
+      hash = _UG_HashString( str );
+      if ( (wnd->title.str == str) && (wnd->title.str_hash == hash) ) return UG_RESULT_OK;
       wnd->title.str = str;
+      wnd->title.str_hash = hash;
+      wnd->title.layout.valid = 0;
       wnd->state |= WND_STATE_UPDATE | WND_STATE_REDRAW_TITLE;
       return UG_RESULT_OK;
    }
@@ -6099,11 +8119,13 @@ UG_RESULT UG_WindowSetTitleTextFont( UG_WINDOW* wnd, const UG_FONT* font )
 {
    if ( (wnd != NULL) && (wnd->state & WND_STATE_VALID) )
    {
+      if ( wnd->title.font == font ) return UG_RESULT_OK;
       wnd->state |= WND_STATE_UPDATE | WND_STATE_REDRAW_TITLE;
       wnd->title.font = font;
-      if ( wnd->title.height <= (font->char_height + 1) )
+      wnd->title.layout.valid = 0;
+      if ( wnd->title.height <= (_UG_GetCharHeight( font ) + 1) )
       {
-         wnd->title.height = font->char_height + 2;
+         wnd->title.height = _UG_GetCharHeight( font ) + 2;
          wnd->state &= ~WND_STATE_REDRAW_TITLE;
       }
       return UG_RESULT_OK;
@@ -6115,7 +8137,9 @@ UG_RESULT UG_WindowSetTitleTextHSpace( UG_WINDOW* wnd, UG_S8 hs )
 {
    if ( (wnd != NULL) && (wnd->state & WND_STATE_VALID) )
    {
+      if ( wnd->title.h_space == hs ) return UG_RESULT_OK;
       wnd->title.h_space = hs;
+      wnd->title.layout.valid = 0;
       wnd->state |= WND_STATE_UPDATE | WND_STATE_REDRAW_TITLE;
       return UG_RESULT_OK;
    }
@@ -6126,7 +8150,9 @@ UG_RESULT UG_WindowSetTitleTextVSpace( UG_WINDOW* wnd, UG_S8 vs )
 {
    if ( (wnd != NULL) && (wnd->state & WND_STATE_VALID) )
    {
+      if ( wnd->title.v_space == vs ) return UG_RESULT_OK;
       wnd->title.v_space = vs;
+      wnd->title.layout.valid = 0;
       wnd->state |= WND_STATE_UPDATE | WND_STATE_REDRAW_TITLE;
       return UG_RESULT_OK;
    }
@@ -6137,7 +8163,9 @@ UG_RESULT UG_WindowSetTitleTextAlignment( UG_WINDOW* wnd, UG_U8 align )
 {
    if ( (wnd != NULL) && (wnd->state & WND_STATE_VALID) )
    {
+      if ( wnd->title.align == align ) return UG_RESULT_OK;
       wnd->title.align = align;
+      wnd->title.layout.valid = 0;
       wnd->state |= WND_STATE_UPDATE | WND_STATE_REDRAW_TITLE;
       return UG_RESULT_OK;
    }
@@ -6148,6 +8176,7 @@ UG_RESULT UG_WindowSetTitleHeight( UG_WINDOW* wnd, UG_U8 height )
 {
    if ( (wnd != NULL) && (wnd->state & WND_STATE_VALID) )
    {
+      if ( wnd->title.height == height ) return UG_RESULT_OK;
       wnd->title.height = height;
       wnd->state &= ~WND_STATE_REDRAW_TITLE;
       wnd->state |= WND_STATE_UPDATE;
@@ -6160,6 +8189,7 @@ UG_RESULT UG_WindowSetXStart( UG_WINDOW* wnd, UG_S16 xs )
 {
    if ( (wnd != NULL) && (wnd->state & WND_STATE_VALID) )
    {
+      if ( wnd->xs == xs ) return UG_RESULT_OK;
       wnd->xs = xs;
       if ( UG_WindowResize( wnd, wnd->xs, wnd->ys, wnd->xe, wnd->ye) == UG_RESULT_FAIL ) return UG_RESULT_FAIL;
       return UG_RESULT_OK;
@@ -6171,6 +8201,7 @@ UG_RESULT UG_WindowSetYStart( UG_WINDOW* wnd, UG_S16 ys )
 {
    if ( (wnd != NULL) && (wnd->state & WND_STATE_VALID) )
    {
+      if ( wnd->ys == ys ) return UG_RESULT_OK;
       wnd->ys = ys;
       if ( UG_WindowResize( wnd, wnd->xs, wnd->ys, wnd->xe, wnd->ye) == UG_RESULT_FAIL ) return UG_RESULT_FAIL;
       return UG_RESULT_OK;
@@ -6182,6 +8213,7 @@ UG_RESULT UG_WindowSetXEnd( UG_WINDOW* wnd, UG_S16 xe )
 {
    if ( (wnd != NULL) && (wnd->state & WND_STATE_VALID) )
    {
+      if ( wnd->xe == xe ) return UG_RESULT_OK;
       wnd->xe = xe;
       if ( UG_WindowResize( wnd, wnd->xs, wnd->ys, wnd->xe, wnd->ye) == UG_RESULT_FAIL ) return UG_RESULT_FAIL;
       return UG_RESULT_OK;
@@ -6193,6 +8225,7 @@ UG_RESULT UG_WindowSetYEnd( UG_WINDOW* wnd, UG_S16 ye )
 {
    if ( (wnd != NULL) && (wnd->state & WND_STATE_VALID) )
    {
+      if ( wnd->ye == ye ) return UG_RESULT_OK;
       wnd->ye = ye;
       if ( UG_WindowResize( wnd, wnd->xs, wnd->ys, wnd->xe, wnd->ye) == UG_RESULT_FAIL ) return UG_RESULT_FAIL;
       return UG_RESULT_OK;
@@ -6204,6 +8237,7 @@ UG_RESULT UG_WindowSetStyle( UG_WINDOW* wnd, UG_U8 style )
 {
    if ( (wnd != NULL) && (wnd->state & WND_STATE_VALID) )
    {
+      if ( (wnd->style & (WND_STYLE_3D | WND_STYLE_SHOW_TITLE)) == (style & (WND_STYLE_3D | WND_STYLE_SHOW_TITLE)) ) return UG_RESULT_OK;
       /* 3D or 2D? */
       if ( style & WND_STYLE_3D )
       {
@@ -6523,8 +8557,10 @@ UG_RESULT _UG_WindowDrawTitle( UG_WINDOW* wnd )
       txt.a.xe = xe;
       txt.a.ye = ys+wnd->title.height-1;
       txt.align = wnd->title.align;
+      txt.style = TXT_STYLE_TRANSPARENT | TXT_STYLE_FILLED;
       txt.h_space = wnd->title.h_space;
       txt.v_space = wnd->title.v_space;
+      txt.layout = &wnd->title.layout;
       _UG_PutText( &txt );
 
       /* Draw line */
@@ -6631,6 +8667,8 @@ UG_RESULT UG_ButtonCreate( UG_WINDOW* wnd, UG_BUTTON* btn, UG_U8 id, UG_S16 xs,
    if (gui != NULL) btn->font = &gui->font;
    else btn->font = NULL;
    btn->str = "-";
+   btn->str_hash = _UG_HashString( btn->str );
+   btn->layout.valid = 0;
 
    /* Initialize standard object parameters */
    obj->update = _UG_ButtonUpdate;
@@ -6701,6 +8739,7 @@ UG_RESULT UG_ButtonSetForeColor( UG_WINDOW* wnd, UG_U8 id, UG_COLOR fc )
    if ( obj == NULL ) return UG_RESULT_FAIL;
 
    btn = (UG_BUTTON*)(obj->data);
+   if ( btn->fc == fc ) return UG_RESULT_OK;
    btn->fc = fc;
    obj->state |= OBJ_STATE_UPDATE | OBJ_STATE_REDRAW;
 
@@ -6716,6 +8755,7 @@ UG_RESULT UG_ButtonSetBackColor( UG_WINDOW* wnd, UG_U8 id, UG_COLOR bc )
    if ( obj == NULL ) return UG_RESULT_FAIL;
 
    btn = (UG_BUTTON*)(obj->data);
+   if ( btn->bc == bc ) return UG_RESULT_OK;
    btn->bc = bc;
    obj->state |= OBJ_STATE_UPDATE | OBJ_STATE_REDRAW;
 
@@ -6731,6 +8771,7 @@ UG_RESULT UG_ButtonSetAlternateForeColor( UG_WINDOW* wnd, UG_U8 id, UG_COLOR afc
    if ( obj == NULL ) return UG_RESULT_FAIL;
 
    btn = (UG_BUTTON*)(obj->data);
+   if ( btn->afc == afc ) return UG_RESULT_OK;
    btn->afc = afc;
    obj->state |= OBJ_STATE_UPDATE | OBJ_STATE_REDRAW;
 
@@ -6746,6 +8787,7 @@ UG_RESULT UG_ButtonSetAlternateBackColor( UG_WINDOW* wnd, UG_U8 id, UG_COLOR abc
    if ( obj == NULL ) return UG_RESULT_FAIL;
 
    btn = (UG_BUTTON*)(obj->data);
+   if ( btn->abc == abc ) return UG_RESULT_OK;
    btn->abc = abc;
    obj->state |= OBJ_STATE_UPDATE | OBJ_STATE_REDRAW;
 
@@ -6756,12 +8798,18 @@ UG_RESULT UG_ButtonSetText( UG_WINDOW* wnd, UG_U8 id, char* str )
 {
    UG_OBJECT* obj=NULL;
    UG_BUTTON* btn=NULL;
+   UG_U32 hash;
 
    obj = _UG_SearchObject( wnd, OBJ_TYPE_BUTTON, id );
    if ( obj == NULL ) return UG_RESULT_FAIL;
 
    btn = (UG_BUTTON*)(obj->data);
+   /* The same buffer may be set again with a new content */
+   hash = _UG_HashString( str );
+   if ( (btn->str == str) && (btn->str_hash == hash) ) return UG_RESULT_OK;
    btn->str = str;
+   btn->str_hash = hash;
+   btn->layout.valid = 0;
    obj->state |= OBJ_STATE_UPDATE | OBJ_STATE_REDRAW;
 
    return UG_RESULT_OK;
@@ -6776,7 +8824,9 @@ UG_RESULT UG_ButtonSetFont( UG_WINDOW* wnd, UG_U8 id, const UG_FONT* font )
    if ( obj == NULL ) return UG_RESULT_FAIL;
 
    btn = (UG_BUTTON*)(obj->data);
+   if ( btn->font == font ) return UG_RESULT_OK;
    btn->font = font;
+   btn->layout.valid = 0;
    obj->state |= OBJ_STATE_UPDATE | OBJ_STATE_REDRAW;
 
    return UG_RESULT_OK;
@@ -6786,14 +8836,17 @@ UG_RESULT UG_ButtonSetStyle( UG_WINDOW* wnd, UG_U8 id, UG_U8 style )
 {
    UG_OBJECT* obj=NULL;
    UG_BUTTON* btn=NULL;
+   UG_U8 style_old,state_old;
 
    obj = _UG_SearchObject( wnd, OBJ_TYPE_BUTTON, id );
    if ( obj == NULL ) return UG_RESULT_FAIL;
 
    btn = (UG_BUTTON*)(obj->data);
+   style_old = btn->style;
+   state_old = btn->state;
 
    /* Select color scheme */
-   btn->style &= ~(BTN_STYLE_USE_ALTERNATE_COLORS | BTN_STYLE_TOGGLE_COLORS | BTN_STYLE_NO_BORDERS | BTN_STYLE_NO_FILL);
+   btn->style &= ~(BTN_STYLE_USE_ALTERNATE_COLORS | BTN_STYLE_TOGGLE_COLORS | BTN_STYLE_NO_BORDERS | BTN_STYLE_NO_FILL | BTN_STYLE_WORD_WRAP | BTN_STYLE_ELLIPSIS);
    btn->state |= BTN_STATE_ALWAYS_REDRAW;
    if ( style & BTN_STYLE_NO_BORDERS )
    {
@@ -6803,6 +8856,10 @@ UG_RESULT UG_ButtonSetStyle( UG_WINDOW* wnd, UG_U8 id, UG_U8 style )
    {
       btn->style |= BTN_STYLE_NO_FILL;
    }
+
+   /* Text layout */
+   btn->style |= style & (BTN_STYLE_WORD_WRAP | BTN_STYLE_ELLIPSIS);
+   btn->layout.valid = 0;
    if ( style & BTN_STYLE_TOGGLE_COLORS )
    {
       btn->style |= BTN_STYLE_TOGGLE_COLORS;
@@ -6825,6 +8882,7 @@ UG_RESULT UG_ButtonSetStyle( UG_WINDOW* wnd, UG_U8 id, UG_U8 style )
    {
       btn->style &= ~BTN_STYLE_3D;
    }
+   if ( (btn->style == style_old) && (btn->state == state_old) ) return UG_RESULT_OK;
    obj->state |= OBJ_STATE_UPDATE | OBJ_STATE_REDRAW;
 
    return UG_RESULT_OK;
@@ -6839,7 +8897,9 @@ UG_RESULT UG_ButtonSetHSpace( UG_WINDOW* wnd, UG_U8 id, UG_S8 hs )
    if ( obj == NULL ) return UG_RESULT_FAIL;
 
    btn = (UG_BUTTON*)(obj->data);
+   if ( btn->h_space == hs ) return UG_RESULT_OK;
    btn->h_space = hs;
+   btn->layout.valid = 0;
    obj->state |= OBJ_STATE_UPDATE | OBJ_STATE_REDRAW;
 
    return UG_RESULT_OK;
@@ -6854,7 +8914,9 @@ UG_RESULT UG_ButtonSetVSpace( UG_WINDOW* wnd, UG_U8 id, UG_S8 vs )
    if ( obj == NULL ) return UG_RESULT_FAIL;
 
    btn = (UG_BUTTON*)(obj->data);
+   if ( btn->v_space == vs ) return UG_RESULT_OK;
    btn->v_space = vs;
+   btn->layout.valid = 0;
    obj->state |= OBJ_STATE_UPDATE | OBJ_STATE_REDRAW;
 
    return UG_RESULT_OK;
@@ -6869,7 +8931,9 @@ UG_RESULT UG_ButtonSetAlignment( UG_WINDOW* wnd, UG_U8 id, UG_U8 align )
    if ( obj == NULL ) return UG_RESULT_FAIL;
 
    btn = (UG_BUTTON*)(obj->data);
+   if ( btn->align == align ) return UG_RESULT_OK;
    btn->align = align;
+   btn->layout.valid = 0;
    obj->state |= OBJ_STATE_UPDATE | OBJ_STATE_REDRAW;
 
    return UG_RESULT_OK;
@@ -7116,10 +9180,14 @@ void _UG_ButtonUpdate(UG_WINDOW* wnd, UG_OBJECT* obj)
             txt.a.xe = obj->a_abs.xe-d;
             txt.a.ye = obj->a_abs.ye-d;
             txt.align = btn->align;
+            txt.style = ( btn->style & BTN_STYLE_NO_FILL ) ? 0 : (TXT_STYLE_TRANSPARENT | TXT_STYLE_FILLED);
+            if ( btn->style & BTN_STYLE_WORD_WRAP ) txt.style |= TXT_STYLE_WORD_WRAP;
+            if ( btn->style & BTN_STYLE_ELLIPSIS ) txt.style |= TXT_STYLE_ELLIPSIS;
             txt.font = btn->font;
             txt.h_space = 2;
             txt.v_space = 2;
             txt.str = btn->str;
+            txt.layout = &btn->layout;
             _UG_PutText( &txt );
             obj->state &= ~OBJ_STATE_REDRAW;
 #ifdef USE_POSTRENDER_EVENT
@@ -7169,7 +9237,9 @@ UG_RESULT UG_CheckboxCreate( UG_WINDOW* wnd, UG_CHECKBOX* chb, UG_U8 id, UG_S16
    if (gui != NULL) chb->font = &gui->font;
    else chb->font = NULL;
    chb->str = "-";
+   chb->str_hash = _UG_HashString( chb->str );
    chb->checked = 0; 
+   chb->layout.valid = 0;
 
    /* Initialize standard object parameters */
    obj->update = _UG_CheckboxUpdate;
@@ -7240,6 +9310,7 @@ UG_RESULT UG_CheckboxSetCheched( UG_WINDOW* wnd, UG_U8 id, UG_U8 ch )
    if ( obj == NULL ) return UG_RESULT_FAIL;
 
    btn = (UG_CHECKBOX*)(obj->data);
+   if ( btn->checked == ch ) return UG_RESULT_OK;
    btn->checked = ch;
    obj->state |= OBJ_STATE_UPDATE | OBJ_STATE_REDRAW;
 
@@ -7256,6 +9327,7 @@ UG_RESULT UG_CheckboxSetForeColor( UG_WINDOW* wnd, UG_U8 id, UG_COLOR fc )
    if ( obj == NULL ) return UG_RESULT_FAIL;
 
    btn = (UG_CHECKBOX*)(obj->data);
+   if ( btn->fc == fc ) return UG_RESULT_OK;
    btn->fc = fc;
    obj->state |= OBJ_STATE_UPDATE | OBJ_STATE_REDRAW;
 
@@ -7271,6 +9343,7 @@ UG_RESULT UG_CheckboxSetBackColor( UG_WINDOW* wnd, UG_U8 id, UG_COLOR bc )
    if ( obj == NULL ) return UG_RESULT_FAIL;
 
    btn = (UG_CHECKBOX*)(obj->data);
+   if ( btn->bc == bc ) return UG_RESULT_OK;
    btn->bc = bc;
    obj->state |= OBJ_STATE_UPDATE | OBJ_STATE_REDRAW;
 
@@ -7286,6 +9359,7 @@ UG_RESULT UG_CheckboxSetAlternateForeColor( UG_WINDOW* wnd, UG_U8 id, UG_COLOR a
    if ( obj == NULL ) return UG_RESULT_FAIL;
 
    btn = (UG_CHECKBOX*)(obj->data);
+   if ( btn->afc == afc ) return UG_RESULT_OK;
    btn->afc = afc;
    obj->state |= OBJ_STATE_UPDATE | OBJ_STATE_REDRAW;
 
@@ -7301,6 +9375,7 @@ UG_RESULT UG_CheckboxSetAlternateBackColor( UG_WINDOW* wnd, UG_U8 id, UG_COLOR a
    if ( obj == NULL ) return UG_RESULT_FAIL;
 
    btn = (UG_CHECKBOX*)(obj->data);
+   if ( btn->abc == abc ) return UG_RESULT_OK;
    btn->abc = abc;
    obj->state |= OBJ_STATE_UPDATE | OBJ_STATE_REDRAW;
 
@@ -7311,12 +9386,18 @@ UG_RESULT UG_CheckboxSetText( UG_WINDOW* wnd, UG_U8 id, char* str )
 {
    UG_OBJECT* obj=NULL;
    UG_CHECKBOX* btn=NULL;
+   UG_U32 hash;
 
    obj = _UG_SearchObject( wnd, OBJ_TYPE_CHECKBOX, id );
    if ( obj == NULL ) return UG_RESULT_FAIL;
 
    btn = (UG_CHECKBOX*)(obj->data);
+   /* The same buffer may be set again with a new content */
+   hash = _UG_HashString( str );
+   if ( (btn->str == str) && (btn->str_hash == hash) ) return UG_RESULT_OK;
    btn->str = str;
+   btn->str_hash = hash;
+   btn->layout.valid = 0;
    obj->state |= OBJ_STATE_UPDATE | OBJ_STATE_REDRAW;
 
    return UG_RESULT_OK;
@@ -7331,7 +9412,9 @@ UG_RESULT UG_CheckboxSetFont( UG_WINDOW* wnd, UG_U8 id, const UG_FONT* font )
    if ( obj == NULL ) return UG_RESULT_FAIL;
 
    btn = (UG_CHECKBOX*)(obj->data);
+   if ( btn->font == font ) return UG_RESULT_OK;
    btn->font = font;
+   btn->layout.valid = 0;
    obj->state |= OBJ_STATE_UPDATE | OBJ_STATE_REDRAW;
 
    return UG_RESULT_OK;
@@ -7341,11 +9424,14 @@ UG_RESULT UG_CheckboxSetStyle( UG_WINDOW* wnd, UG_U8 id, UG_U8 style )
 {
    UG_OBJECT* obj=NULL;
    UG_CHECKBOX* chk=NULL;
+   UG_U8 style_old,state_old;
 
    obj = _UG_SearchObject( wnd, OBJ_TYPE_CHECKBOX, id );
    if ( obj == NULL ) return UG_RESULT_FAIL;
 
    chk = (UG_CHECKBOX*)(obj->data);
+   style_old = chk->style;
+   state_old = chk->state;
 
    /* Select color scheme */
    chk->style &= ~(CHB_STYLE_USE_ALTERNATE_COLORS | CHB_STYLE_TOGGLE_COLORS | CHB_STYLE_NO_BORDERS | CHB_STYLE_NO_FILL);
@@ -7380,6 +9466,7 @@ UG_RESULT UG_CheckboxSetStyle( UG_WINDOW* wnd, UG_U8 id, UG_U8 style )
    {
       chk->style &= ~CHB_STYLE_3D;
    }
+   if ( (chk->style == style_old) && (chk->state == state_old) ) return UG_RESULT_OK;
    obj->state |= OBJ_STATE_UPDATE | OBJ_STATE_REDRAW;
 
    return UG_RESULT_OK;
@@ -7394,7 +9481,9 @@ UG_RESULT UG_CheckboxSetHSpace( UG_WINDOW* wnd, UG_U8 id, UG_S8 hs )
    if ( obj == NULL ) return UG_RESULT_FAIL;
 
    btn = (UG_CHECKBOX*)(obj->data);
+   if ( btn->h_space == hs ) return UG_RESULT_OK;
    btn->h_space = hs;
+   btn->layout.valid = 0;
    obj->state |= OBJ_STATE_UPDATE | OBJ_STATE_REDRAW;
 
    return UG_RESULT_OK;
@@ -7409,7 +9498,9 @@ UG_RESULT UG_CheckboxSetVSpace( UG_WINDOW* wnd, UG_U8 id, UG_S8 vs )
    if ( obj == NULL ) return UG_RESULT_FAIL;
 
    btn = (UG_CHECKBOX*)(obj->data);
+   if ( btn->v_space == vs ) return UG_RESULT_OK;
    btn->v_space = vs;
+   btn->layout.valid = 0;
    obj->state |= OBJ_STATE_UPDATE | OBJ_STATE_REDRAW;
 
    return UG_RESULT_OK;
@@ -7424,7 +9515,9 @@ UG_RESULT UG_CheckboxSetAlignment( UG_WINDOW* wnd, UG_U8 id, UG_U8 align )
    if ( obj == NULL ) return UG_RESULT_FAIL;
 
    btn = (UG_CHECKBOX*)(obj->data);
+   if ( btn->align == align ) return UG_RESULT_OK;
    btn->align = align;
+   btn->layout.valid = 0;
    obj->state |= OBJ_STATE_UPDATE | OBJ_STATE_REDRAW;
 
    return UG_RESULT_OK;
@@ -7602,7 +9695,7 @@ void _UG_CheckboxUpdate(UG_WINDOW* wnd, UG_OBJECT* obj)
    UG_AREA a;
    UG_TEXT txt;
    UG_U8 d;
-   UG_U8 d2;
+   UG_S16 d2;
 
    /* Get object-specific data */
    chb = (UG_CHECKBOX*)(obj->data);
@@ -7655,6 +9748,7 @@ void _UG_CheckboxUpdate(UG_WINDOW* wnd, UG_OBJECT* obj)
          /* 3D or 2D style? */
          d  = ( chb->style & CHB_STYLE_3D )? 3:1;
          d2 = (chb->font->char_width < chb->font->char_height) ? chb->font->char_height : chb->font->char_width;
+         if ( chb->font->scale > 1 ) d2 *= chb->font->scale;
           
          /* Full redraw necessary? */
          if ( (obj->state & OBJ_STATE_REDRAW) || (chb->state & CHB_STATE_ALWAYS_REDRAW) )
@@ -7694,10 +9788,12 @@ void _UG_CheckboxUpdate(UG_WINDOW* wnd, UG_OBJECT* obj)
             txt.a.xe = obj->a_abs.xe;
             txt.a.ye = obj->a_abs.ye;
             txt.align = chb->align;
+            txt.style = ( chb->style & CHB_STYLE_NO_FILL ) ? 0 : TXT_STYLE_TRANSPARENT;
             txt.font = chb->font;
             txt.h_space = 2;
             txt.v_space = 2;
             txt.str = chb->str;
+            txt.layout = &chb->layout;
             _UG_PutText( &txt );
             obj->state &= ~OBJ_STATE_REDRAW;
 #ifdef USE_POSTRENDER_EVENT
@@ -7761,14 +9857,26 @@ UG_RESULT UG_TextboxCreate( UG_WINDOW* wnd, UG_TEXTBOX* txb, UG_U8 id, UG_S16 xs
 
    /* Initialize object-specific parameters */
    txb->str = NULL;
+   txb->str_hash = 0;
+#ifdef USE_LABEL_CACHE
+   txb->drawn_hash = 0;
+#endif
    if (gui != NULL) txb->font = &gui->font;
    else txb->font = NULL;
-   txb->style = 0; /* reserved */
+   txb->style = 0;
    txb->fc = wnd->fc;
    txb->bc = wnd->bc;
    txb->align = ALIGN_CENTER;
    txb->h_space = 0;
    txb->v_space = 0;
+   txb->layout.valid = 0;
+#ifdef USE_TEXTBOX_DIFF
+   txb->last_valid = 0;
+#endif
+#ifdef USE_TEXTBOX_NUMBER
+   txb->num[0] = 0;
+   txb->num_last[0] = 0;
+#endif
 
    /* Initialize standard object parameters */
    obj->update = _UG_TextboxUpdate;
@@ -7833,6 +9941,7 @@ UG_RESULT UG_TextboxSetForeColor( UG_WINDOW* wnd, UG_U8 id, UG_COLOR fc )
    if ( obj == NULL ) return UG_RESULT_FAIL;
 
    txb = (UG_TEXTBOX*)(obj->data);
+   if ( txb->fc == fc ) return UG_RESULT_OK;
    txb->fc = fc;
    obj->state |= OBJ_STATE_UPDATE | OBJ_STATE_REDRAW;
 
@@ -7848,6 +9957,7 @@ UG_RESULT UG_TextboxSetBackColor( UG_WINDOW* wnd, UG_U8 id, UG_COLOR bc )
    if ( obj == NULL ) return UG_RESULT_FAIL;
 
    txb = (UG_TEXTBOX*)(obj->data);
+   if ( txb->bc == bc ) return UG_RESULT_OK;
    txb->bc = bc;
    obj->state |= OBJ_STATE_UPDATE | OBJ_STATE_REDRAW;
 
@@ -7858,13 +9968,25 @@ UG_RESULT UG_TextboxSetText( UG_WINDOW* wnd, UG_U8 id, char* str )
 {
    UG_OBJECT* obj=NULL;
    UG_TEXTBOX* txb=NULL;
+   UG_U32 hash;
 
    obj = _UG_SearchObject( wnd, OBJ_TYPE_TEXTBOX, id );
    if ( obj == NULL ) return UG_RESULT_FAIL;
 
    txb = (UG_TEXTBOX*)(obj->data);
+   /* The same buffer may be set again with a new content */
+   hash = _UG_HashString( str );
+   if ( (txb->str == str) && (txb->str_hash == hash) ) return UG_RESULT_OK;
    txb->str = str;
+   txb->str_hash = hash;
+   txb->layout.valid = 0;
+#ifdef USE_TEXTBOX_DIFF
+   /* The update only redraws the changed characters */
+   obj->state |= OBJ_STATE_UPDATE;
+   if ( !txb->last_valid ) obj->state |= OBJ_STATE_REDRAW;
+#else
    obj->state |= OBJ_STATE_UPDATE | OBJ_STATE_REDRAW;
+#endif
 
    return UG_RESULT_OK;
 }
@@ -7878,7 +10000,9 @@ UG_RESULT UG_TextboxSetFont( UG_WINDOW* wnd, UG_U8 id, const UG_FONT* font )
    if ( obj == NULL ) return UG_RESULT_FAIL;
 
    txb = (UG_TEXTBOX*)(obj->data);
+   if ( txb->font == font ) return UG_RESULT_OK;
    txb->font = font;
+   txb->layout.valid = 0;
    obj->state |= OBJ_STATE_UPDATE | OBJ_STATE_REDRAW;
 
    return UG_RESULT_OK;
@@ -7893,7 +10017,9 @@ UG_RESULT UG_TextboxSetHSpace( UG_WINDOW* wnd, UG_U8 id, UG_S8 hs )
    if ( obj == NULL ) return UG_RESULT_FAIL;
 
    txb = (UG_TEXTBOX*)(obj->data);
+   if ( txb->h_space == hs ) return UG_RESULT_OK;
    txb->h_space = hs;
+   txb->layout.valid = 0;
    obj->state |= OBJ_STATE_UPDATE | OBJ_STATE_REDRAW;
 
    return UG_RESULT_OK;
@@ -7908,7 +10034,9 @@ UG_RESULT UG_TextboxSetVSpace( UG_WINDOW* wnd, UG_U8 id, UG_S8 vs )
    if ( obj == NULL ) return UG_RESULT_FAIL;
 
    txb = (UG_TEXTBOX*)(obj->data);
+   if ( txb->v_space == vs ) return UG_RESULT_OK;
    txb->v_space = vs;
+   txb->layout.valid = 0;
    obj->state |= OBJ_STATE_UPDATE | OBJ_STATE_REDRAW;
 
    return UG_RESULT_OK;
@@ -7923,12 +10051,67 @@ UG_RESULT UG_TextboxSetAlignment( UG_WINDOW* wnd, UG_U8 id, UG_U8 align )
    if ( obj == NULL ) return UG_RESULT_FAIL;
 
    txb = (UG_TEXTBOX*)(obj->data);
+   if ( txb->align == align ) return UG_RESULT_OK;
    txb->align = align;
+   txb->layout.valid = 0;
+   obj->state |= OBJ_STATE_UPDATE | OBJ_STATE_REDRAW;
+
+   return UG_RESULT_OK;
+}
+
+UG_RESULT UG_TextboxSetStyle( UG_WINDOW* wnd, UG_U8 id, UG_U8 style )
+{
+   UG_OBJECT* obj=NULL;
+   UG_TEXTBOX* txb=NULL;
+
+   obj = _UG_SearchObject( wnd, OBJ_TYPE_TEXTBOX, id );
+   if ( obj == NULL ) return UG_RESULT_FAIL;
+
+   txb = (UG_TEXTBOX*)(obj->data);
+   if ( txb->style == style ) return UG_RESULT_OK;
+   txb->style = style;
+   txb->layout.valid = 0;
    obj->state |= OBJ_STATE_UPDATE | OBJ_STATE_REDRAW;
 
    return UG_RESULT_OK;
 }
 
+#ifdef USE_TEXTBOX_NUMBER
+UG_RESULT UG_TextboxSetNumber( UG_WINDOW* wnd, UG_U8 id, UG_S32 value, UG_U8 width, UG_U8 decimals, UG_U8 flags )
+{
+   UG_OBJECT* obj=NULL;
+   UG_TEXTBOX* txb=NULL;
+   char num[UG_TEXTBOX_NUMBER_LENGTH];
+   UG_U8 i;
+
+   obj = _UG_SearchObject( wnd, OBJ_TYPE_TEXTBOX, id );
+   if ( obj == NULL ) return UG_RESULT_FAIL;
+   if ( !UG_FormatNumber( num, UG_TEXTBOX_NUMBER_LENGTH, value, width, decimals, flags ) ) return UG_RESULT_FAIL;
+
+   txb = (UG_TEXTBOX*)(obj->data);
+   if ( txb->str == txb->num )
+   {
+      for( i=0;(num[i] == txb->num[i]) && num[i];i++ );
+      if ( num[i] == txb->num[i] ) return UG_RESULT_OK;
+      /* The update only redraws the changed digits */
+      obj->state |= OBJ_STATE_UPDATE;
+   }
+   else
+   {
+      txb->str = txb->num;
+      obj->state |= OBJ_STATE_UPDATE | OBJ_STATE_REDRAW;
+   }
+   for( i=0;i<UG_TEXTBOX_NUMBER_LENGTH;i++ ) txb->num[i] = num[i];
+   txb->str_hash = _UG_HashString( txb->num );
+   txb->layout.valid = 0;
+#ifdef USE_TEXTBOX_DIFF
+   txb->last_valid = 0;
+#endif
+
+   return UG_RESULT_OK;
+}
+#endif
+
 UG_COLOR UG_TextboxGetForeColor( UG_WINDOW* wnd, UG_U8 id )
 {
    UG_OBJECT* obj=NULL;
@@ -8034,11 +10217,29 @@ UG_U8 UG_TextboxGetAlignment( UG_WINDOW* wnd, UG_U8 id )
    return align;
 }
 
+UG_U8 UG_TextboxGetStyle( UG_WINDOW* wnd, UG_U8 id )
+{
+   UG_OBJECT* obj=NULL;
+   UG_TEXTBOX* txb=NULL;
+   UG_U8 style = 0;
+
+   obj = _UG_SearchObject( wnd, OBJ_TYPE_TEXTBOX, id );
+   if ( obj != NULL )
+   {
+      txb = (UG_TEXTBOX*)(obj->data);
+      style = txb->style;
+   }
+   return style;
+}
+
 void _UG_TextboxUpdate(UG_WINDOW* wnd, UG_OBJECT* obj)
 {
    UG_TEXTBOX* txb;
    UG_AREA a;
    UG_TEXT txt;
+#ifdef USE_PRERENDER_EVENT
+   UG_U8 pre;
+#endif
 
    /* Get object-specific data */
    txb = (UG_TEXTBOX*)(obj->data);
@@ -8054,8 +10255,38 @@ void _UG_TextboxUpdate(UG_WINDOW* wnd, UG_OBJECT* obj)
    /* -------------------------------------------------- */
    if ( obj->state & OBJ_STATE_UPDATE )
    {
+#ifdef USE_PRERENDER_EVENT
+      pre = 0;
+#endif
       if ( obj->state & OBJ_STATE_VISIBLE )
       {
+#ifdef USE_TEXTBOX_NUMBER
+         if ( txb->str == txb->num )
+         {
+            _UG_TextboxUpdateNumber( wnd, obj );
+            obj->state &= ~OBJ_STATE_UPDATE;
+            return;
+         }
+#endif
+#ifdef USE_TEXTBOX_DIFF
+         /* Only the text has changed? */
+         if ( !(obj->state & OBJ_STATE_REDRAW) )
+         {
+#ifdef USE_PRERENDER_EVENT
+            _UG_SendObjectPrerenderEvent(wnd, obj);
+            pre = 1;
+#endif
+            _UG_TextboxGetText( obj, &txt );
+            if ( _UG_TextboxRedrawChanges( txb, &txt ) )
+            {
+               _UG_TextboxSaveText( txb );
+#ifdef USE_POSTRENDER_EVENT
+               _UG_SendObjectPostrenderEvent(wnd, obj);
+#endif
+            }
+            else obj->state |= OBJ_STATE_REDRAW;
+         }
+#endif
          /* Full redraw necessary? */
          if ( obj->state & OBJ_STATE_REDRAW )
          {
@@ -8067,25 +10298,21 @@ void _UG_TextboxUpdate(UG_WINDOW* wnd, UG_OBJECT* obj)
             if ( obj->a_abs.ye >= wnd->ye ) return;
             if ( obj->a_abs.xe >= wnd->xe ) return;
 #ifdef USE_PRERENDER_EVENT
-            _UG_SendObjectPrerenderEvent(wnd, obj);
+            /* Already sent if the changes couldn't be drawn on their own */
+            if ( !pre ) _UG_SendObjectPrerenderEvent(wnd, obj);
 #endif
 
-            txt.bc = txb->bc;
-            txt.fc = txb->fc;
-
-            UG_FillFrame(obj->a_abs.xs, obj->a_abs.ys, obj->a_abs.xe, obj->a_abs.ye, txt.bc);
+            UG_FillFrame(obj->a_abs.xs, obj->a_abs.ys, obj->a_abs.xe, obj->a_abs.ye, txb->bc);
 
             /* Draw Textbox text */
-            txt.a.xs = obj->a_abs.xs;
-            txt.a.ys = obj->a_abs.ys;
-            txt.a.xe = obj->a_abs.xe;
-            txt.a.ye = obj->a_abs.ye;
-            txt.align = txb->align;
-            txt.font = txb->font;
-            txt.h_space = txb->h_space;
-            txt.v_space = txb->v_space;
-            txt.str = txb->str;
+            _UG_TextboxGetText( obj, &txt );
             _UG_PutText( &txt );
+#ifdef USE_LABEL_CACHE
+            txb->drawn_hash = txb->str_hash;
+#endif
+#ifdef USE_TEXTBOX_DIFF
+            _UG_TextboxSaveText( txb );
+#endif
             obj->state &= ~OBJ_STATE_REDRAW;
 #ifdef USE_POSTRENDER_EVENT
             _UG_SendObjectPostrenderEvent(wnd, obj);
@@ -8100,6 +10327,214 @@ void _UG_TextboxUpdate(UG_WINDOW* wnd, UG_OBJECT* obj)
    }
 }
 
+/* Fills in the text of a textbox, its area has to be up to date */
+void _UG_TextboxGetText( UG_OBJECT* obj, UG_TEXT* txt )
+{
+   UG_TEXTBOX* txb;
+
+   txb = (UG_TEXTBOX*)(obj->data);
+   txt->bc = txb->bc;
+   txt->fc = txb->fc;
+   txt->a.xs = obj->a_abs.xs;
+   txt->a.ys = obj->a_abs.ys;
+   txt->a.xe = obj->a_abs.xe;
+   txt->a.ye = obj->a_abs.ye;
+   txt->align = txb->align;
+   txt->style = TXT_STYLE_TRANSPARENT | TXT_STYLE_FILLED;
+   if ( txb->style & TXB_STYLE_WORD_WRAP ) txt->style |= TXT_STYLE_WORD_WRAP;
+   if ( txb->style & TXB_STYLE_ELLIPSIS ) txt->style |= TXT_STYLE_ELLIPSIS;
+#ifdef USE_LABEL_CACHE
+   /* A text which has changed since the last draw, e.g. a readout, would */
+   /* only push the static labels out of the cache                        */
+   if ( txb->str_hash != txb->drawn_hash ) txt->style |= TXT_STYLE_NO_CACHE;
+#endif
+   txt->font = txb->font;
+   txt->h_space = txb->h_space;
+   txt->v_space = txb->v_space;
+   txt->str = txb->str;
+   txt->layout = &txb->layout;
+}
+
+#ifdef USE_TEXTBOX_NUMBER
+/* Draws the number of a textbox. Its characters are centered in cells of  */
+/* the width of the widest digit, so as long as the length of the number   */
+/* stays the same only the cells which have changed are redrawn.           */
+void _UG_TextboxUpdateNumber( UG_WINDOW* wnd, UG_OBJECT* obj )
+{
+   UG_TEXTBOX* txb;
+   UG_AREA a;
+   UG_S16 cw,ch,w,x,y,xc;
+   UG_U8 i,n,all;
+
+   txb = (UG_TEXTBOX*)(obj->data);
+   all = ( obj->state & OBJ_STATE_REDRAW ) ? 1:0;
+   if ( all )
+   {
+      UG_WindowGetArea(wnd,&a);
+      obj->a_abs.xs = obj->a_rel.xs + a.xs;
+      obj->a_abs.ys = obj->a_rel.ys + a.ys;
+      obj->a_abs.xe = obj->a_rel.xe + a.xs;
+      obj->a_abs.ye = obj->a_rel.ye + a.ys;
+      if ( obj->a_abs.ye >= wnd->ye ) return;
+      if ( obj->a_abs.xe >= wnd->xe ) return;
+   }
+#ifdef USE_PRERENDER_EVENT
+   _UG_SendObjectPrerenderEvent(wnd, obj);
+#endif
+
+   cw = 0;
+   for( i='0';i<='9';i++ )
+   {
+      w = _UG_GetCharWidth( txb->font, i );
+      if ( w > cw ) cw = w;
+   }
+   ch = _UG_GetCharHeight( txb->font );
+
+   /* A new length moves the cells, overlapping cells can't be drawn alone */
+   for( n=0;txb->num[n];n++ );
+   for( i=0;txb->num_last[i];i++ );
+   if ( (i != n) || (txb->h_space < 0) ) all = 1;
+
+   w = n*cw + ( n ? (n-1)*txb->h_space : 0 );
+   x = obj->a_abs.xs;
+   if ( txb->align & ALIGN_H_RIGHT ) x = obj->a_abs.xe - w + 1;
+   else if ( txb->align & ALIGN_H_CENTER ) x += (obj->a_abs.xe - obj->a_abs.xs + 1 - w) >> 1;
+   y = obj->a_abs.ys;
+   if ( txb->align & ALIGN_V_BOTTOM ) y = obj->a_abs.ye - ch + 1;
+   else if ( txb->align & ALIGN_V_CENTER ) y += (obj->a_abs.ye - obj->a_abs.ys + 1 - ch) >> 1;
+
+   if ( all ) UG_FillFrame(obj->a_abs.xs, obj->a_abs.ys, obj->a_abs.xe, obj->a_abs.ye, txb->bc);
+   /* Like the text path, a number which doesn't fit the box isn't drawn */
+   if ( (txb->font->p != NULL) && (w <= obj->a_abs.xe - obj->a_abs.xs + 1) && (ch <= obj->a_abs.ye - obj->a_abs.ys + 1) )
+   {
+      for( i=0;i<n;i++ )
+      {
+         w = _UG_GetCharWidth( txb->font, txb->num[i] );
+         xc = x + ((cw - w) >> 1);
+         if ( all )
+         {
+            if ( w ) _UG_PutChar( txb->num[i], xc, y, txb->fc, txb->bc, txb->font, 1 );
+         }
+         else if ( txb->num[i] != txb->num_last[i] )
+         {
+            if ( xc > x ) UG_FillFrame( x, y, xc - 1, y + ch - 1, txb->bc );
+            if ( xc + w < x + cw ) UG_FillFrame( xc + w, y, x + cw - 1, y + ch - 1, txb->bc );
+            if ( w ) _UG_PutChar( txb->num[i], xc, y, txb->fc, txb->bc, txb->font, 0 );
+         }
+         x += cw + txb->h_space;
+      }
+   }
+   for( i=0;i<=n;i++ ) txb->num_last[i] = txb->num[i];
+
+   obj->state &= ~OBJ_STATE_REDRAW;
+#ifdef USE_POSTRENDER_EVENT
+   _UG_SendObjectPostrenderEvent(wnd, obj);
+#endif
+}
+#endif
+
+#ifdef USE_TEXTBOX_DIFF
+/* Keeps a copy of the string on the screen. Its layout stays in txb->layout */
+/* until the next redraw.                                                    */
+void _UG_TextboxSaveText( UG_TEXTBOX* txb )
+{
+   UG_U16 n;
+
+   txb->last_valid = 0;
+   if ( (txb->str == NULL) || !txb->layout.valid || (txb->layout.lines > UG_TEXT_LAYOUT_LINES) ) return;
+   for( n=0;txb->str[n];n++ )
+   {
+      if ( n == UG_TEXTBOX_DIFF_LENGTH - 1 ) return;
+      txb->last[n] = txb->str[n];
+   }
+   txb->last[n] = 0;
+   txb->last_valid = 1;
+}
+
+/* Compares the new text of a textbox with the one on the screen and redraws */
+/* the characters which differ. As long as the characters of a line keep    */
+/* their positions only the changed cells are drawn, from the first shifted */
+/* character on the rest of the line is redrawn. Returns 0 if the whole box */
+/* has to be redrawn: the number of lines changed, a line moved (e.g. a     */
+/* centered line got longer), an ellipsis is involved or the characters     */
+/* overlap.                                                                  */
+UG_U8 _UG_TextboxRedrawChanges( UG_TEXTBOX* txb, UG_TEXT* txt )
+{
+   UG_TEXT_LAYOUT old;
+   UG_U16 n,oc,nc;
+   UG_S16 ch,y,xn,ow,nw,xe;
+   char* so;
+   char* sn;
+   char* oe;
+   char* ne;
+   char* t;
+
+   /* Overlapping characters can't be drawn on their own */
+   if ( !txb->last_valid || (txt->str == NULL) || (txt->h_space < 0) ) return 0;
+   old = txb->layout;
+   _UG_LayoutText( txt, &txb->layout );
+   if ( (txb->layout.lines != old.lines) || (txb->layout.y != old.y) || (old.lines > UG_TEXT_LAYOUT_LINES) ) return 0;
+   for( n=0;n<old.lines;n++ )
+   {
+      if ( (txb->layout.line[n].x != old.line[n].x) || old.line[n].ellipsis || txb->layout.line[n].ellipsis ) return 0;
+   }
+
+   ch = _UG_GetCharHeight( txt->font );
+   y = old.y;
+   oc = 0;
+   nc = 0;
+   for( n=0;n<old.lines;n++ )
+   {
+      so = txb->last + old.line[n].start;
+      oe = so + old.line[n].len;
+      sn = txt->str + txb->layout.line[n].start;
+      ne = sn + txb->layout.line[n].len;
+      xn = old.line[n].x;
+      while ( 1 )
+      {
+         /* Next drawn characters of both lines */
+         ow = 0;
+         while ( !ow && (so < oe) )
+         {
+            oc = _UG_DecodeChar( &so );
+            ow = _UG_GetCharWidth( txt->font, oc );
+         }
+         nw = 0;
+         t = sn;
+         while ( !nw && (sn < ne) )
+         {
+            t = sn;
+            nc = _UG_DecodeChar( &sn );
+            nw = _UG_GetCharWidth( txt->font, nc );
+         }
+         if ( !ow || !nw || (ow != nw) ) break;
+
+         if ( oc != nc ) _UG_PutChar( nc, xn, y, txt->fc, txt->bc, txt->font, 0 );
+         xn += nw + txt->h_space;
+      }
+
+      /* The rest of the line is cleared and redrawn */
+      xe = old.line[n].x + old.line[n].w;
+      if ( txb->layout.line[n].x + txb->layout.line[n].w > xe ) xe = txb->layout.line[n].x + txb->layout.line[n].w;
+      if ( xe > xn ) UG_FillFrame( xn, y, xe - 1, y + ch - 1, txt->bc );
+      if ( nw )
+      {
+         sn = t;
+         while ( sn < ne )
+         {
+            nc = _UG_DecodeChar( &sn );
+            nw = _UG_GetCharWidth( txt->font, nc );
+            if ( !nw ) continue;
+            _UG_PutChar( nc, xn, y, txt->fc, txt->bc, txt->font, 1 );
+            xn += nw + txt->h_space;
+         }
+      }
+      y += ch + txt->v_space;
+   }
+   return 1;
+}
+#endif
+
 /* -------------------------------------------------------------------------------- */
 /* -- IMAGE FUNCTIONS                                                            -- */
 /* -------------------------------------------------------------------------------- */
@@ -8177,6 +10612,7 @@ UG_RESULT UG_ImageSetBMP( UG_WINDOW* wnd, UG_U8 id, const UG_BMP* bmp )
    if ( obj == NULL ) return UG_RESULT_FAIL;
 
    img = (UG_IMAGE*)(obj->data);
+   if ( (img->img == (void*)bmp) && (img->type == IMG_TYPE_BMP) ) return UG_RESULT_OK;
    img->img = (void*)bmp;
    img->type = IMG_TYPE_BMP;
    obj->state |= OBJ_STATE_UPDATE | OBJ_STATE_REDRAW;
@@ -8234,4 +10670,371 @@ void _UG_ImageUpdate(UG_WINDOW* wnd, UG_OBJECT* obj)
    }
 }
 
+/* -------------------------------------------------------------------------------- */
+/* -- BINDING FUNCTIONS                                                          -- */
+/* -------------------------------------------------------------------------------- */
+#ifdef USE_BINDING
+UG_RESULT UG_BindingCreate( UG_BINDING* b, UG_WINDOW* wnd, UG_U8 type, UG_U8 id, const void* value, void (*format)( char* str, UG_U16 size, const void* value ) )
+{
+   if ( (b == NULL) || (format == NULL) ) return UG_RESULT_FAIL;
+   if ( (type != OBJ_TYPE_TEXTBOX) && (type != OBJ_TYPE_BUTTON) && (type != OBJ_TYPE_CHECKBOX) ) return UG_RESULT_FAIL;
+   if ( _UG_SearchObject( wnd, type, id ) == NULL ) return UG_RESULT_FAIL;
+
+   /* A binding may be created again, it must not be linked twice */
+   UG_BindingDelete( b );
+   b->wnd = wnd;
+   b->type = type;
+   b->id = id;
+   b->value = value;
+   b->format = format;
+   b->str[0] = 0;
+   format( b->str, UG_BINDING_LENGTH, value );
+   b->str[UG_BINDING_LENGTH-1] = 0;
+   if ( _UG_BindingSetText( b ) != UG_RESULT_OK ) return UG_RESULT_FAIL;
+
+   b->next = gui->bindings;
+   gui->bindings = b;
+   return UG_RESULT_OK;
+}
+
+UG_RESULT UG_BindingDelete( UG_BINDING* b )
+{
+   UG_BINDING** p;
+
+   for( p=&gui->bindings;*p!=NULL;p=&(*p)->next )
+   {
+      if ( *p == b )
+      {
+         *p = b->next;
+         return UG_RESULT_OK;
+      }
+   }
+   return UG_RESULT_FAIL;
+}
+
+UG_RESULT _UG_BindingSetText( UG_BINDING* b )
+{
+   if ( b->type == OBJ_TYPE_TEXTBOX ) return UG_TextboxSetText( b->wnd, b->id, b->str );
+   if ( b->type == OBJ_TYPE_BUTTON ) return UG_ButtonSetText( b->wnd, b->id, b->str );
+   return UG_CheckboxSetText( b->wnd, b->id, b->str );
+}
+
+/* Formats the bound value into str, returns 1 if it differs from the text */
+UG_U8 _UG_BindingFormat( UG_BINDING* b, char* str )
+{
+   UG_U16 i;
+
+   str[0] = 0;
+   b->format( str, UG_BINDING_LENGTH, b->value );
+   str[UG_BINDING_LENGTH-1] = 0;
+   for( i=0;(str[i] == b->str[i]) && str[i];i++ );
+   return str[i] != b->str[i];
+}
+
+/* Returns 1 if any bound value has changed since the last UG_Update() */
+UG_U8 _UG_BindingsChanged( void )
+{
+   UG_BINDING* b;
+   char str[UG_BINDING_LENGTH];
+
+   for( b=gui->bindings;b!=NULL;b=b->next )
+   {
+      if ( _UG_BindingFormat( b, str ) ) return 1;
+   }
+   return 0;
+}
+
+/* Formats all bound values and sets the texts which have changed */
+void _UG_UpdateBindings( void )
+{
+   UG_BINDING* b;
+   char str[UG_BINDING_LENGTH];
+   UG_U16 i;
+
+   for( b=gui->bindings;b!=NULL;b=b->next )
+   {
+      if ( !_UG_BindingFormat( b, str ) ) continue;
+
+      for( i=0;i<UG_BINDING_LENGTH;i++ ) b->str[i] = str[i];
+      _UG_BindingSetText( b );
+   }
+}
+#endif
+
+/* -------------------------------------------------------------------------------- */
+/* -- TIMER FUNCTIONS                                                            -- */
+/* -------------------------------------------------------------------------------- */
+#ifdef USE_TIMER
+/* Starts (or restarts) a timer which calls cb after delay and then every */
+/* period. A period of 0 makes it a one-shot timer.                       */
+UG_RESULT UG_TimerStart( UG_TIMER* t, UG_U32 delay, UG_U32 period, void (*cb)( UG_TIMER* t ), void* data )
+{
+   if ( (t == NULL) || (cb == NULL) || (gui->clock == NULL) ) return UG_RESULT_FAIL;
+
+   UG_TimerStop( t );
+   t->due = gui->clock() + delay;
+   t->period = period;
+   t->cb = cb;
+   t->data = data;
+   _UG_TimerInsert( t );
+   return UG_RESULT_OK;
+}
+
+UG_RESULT UG_TimerStop( UG_TIMER* t )
+{
+   UG_TIMER** p;
+
+   for( p=&gui->timers;*p!=NULL;p=&(*p)->next )
+   {
+      if ( *p == t )
+      {
+         *p = t->next;
+         return UG_RESULT_OK;
+      }
+   }
+   return UG_RESULT_FAIL;
+}
+
+/* The timers are kept sorted by their due time, the first one is the next */
+void _UG_TimerInsert( UG_TIMER* t )
+{
+   UG_TIMER** p;
+
+   for( p=&gui->timers;*p!=NULL;p=&(*p)->next )
+   {
+      if ( (UG_S32)(t->due - (*p)->due) < 0 ) break;
+   }
+   t->next = *p;
+   *p = t;
+}
+
+/* Starts (or restarts) a tween from "from" to "to" over duration. apply is */
+/* called with the start value at once and then whenever the value changes, */
+/* the last call is made with "to".                                          */
+UG_RESULT UG_TweenStart( UG_TWEEN* tw, UG_S32 from, UG_S32 to, UG_U32 duration, UG_U8 curve, void (*apply)( UG_TWEEN* tw, UG_S32 value ), void* data )
+{
+   if ( (tw == NULL) || (apply == NULL) || (gui->clock == NULL) || (curve > TWEEN_EASE_IN_OUT) ) return UG_RESULT_FAIL;
+
+   UG_TweenStop( tw );
+   tw->start = gui->clock();
+   tw->duration = duration;
+   tw->from = from;
+   tw->to = to;
+   tw->value = from;
+   tw->curve = curve;
+   tw->apply = apply;
+   tw->data = data;
+   tw->next = gui->tweens;
+   gui->tweens = tw;
+   apply( tw, from );
+   return UG_RESULT_OK;
+}
+
+UG_RESULT UG_TweenStop( UG_TWEEN* tw )
+{
+   UG_TWEEN** p;
+
+   for( p=&gui->tweens;*p!=NULL;p=&(*p)->next )
+   {
+      if ( *p == tw )
+      {
+         *p = tw->next;
+         return UG_RESULT_OK;
+      }
+   }
+   return UG_RESULT_FAIL;
+}
+
+/* Value of a tween at the given time. The progress and the curves are */
+/* computed with 15 fractional bits.                                    */
+UG_S32 _UG_TweenValue( UG_TWEEN* tw, UG_U32 now )
+{
+   UG_U32 t,d,p,e,u,r;
+
+   t = now - tw->start;
+   d = tw->duration;
+   if ( t >= d ) return tw->to;
+   while ( d > 0xFFFF )
+   {
+      d >>= 1;
+      t >>= 1;
+   }
+   p = ((t << 15) + (d >> 1)) / d;
+
+   switch ( tw->curve )
+   {
+      case TWEEN_EASE_IN:
+         e = (p * p) >> 15;
+         break;
+      case TWEEN_EASE_OUT:
+         e = 0x8000 - (((0x8000 - p) * (0x8000 - p)) >> 15);
+         break;
+      case TWEEN_EASE_IN_OUT:
+         if ( p < 0x4000 ) e = (p * p) >> 14;
+         else e = 0x8000 - (((0x8000 - p) * (0x8000 - p)) >> 14);
+         break;
+      default:
+         e = p;
+         break;
+   }
+
+   /* from + (to - from) * e, split to stay within 32 bits */
+   u = ( tw->to >= tw->from ) ? (UG_U32)tw->to - (UG_U32)tw->from : (UG_U32)tw->from - (UG_U32)tw->to;
+   r = (u >> 15) * e + (((u & 0x7FFF) * e) >> 15);
+   return ( tw->to >= tw->from ) ? (UG_S32)((UG_U32)tw->from + r) : (UG_S32)((UG_U32)tw->from - r);
+}
+
+void _UG_UpdateTimers( UG_U32 now )
+{
+   UG_TIMER* t;
+   UG_TWEEN* tw;
+   UG_TWEEN* next;
+   UG_S32 v;
+   UG_U16 n;
+
+   /* Only the timers due now are run, a callback may restart its timer */
+   n = 0;
+   for( t=gui->timers;(t != NULL) && ((UG_S32)(now - t->due) >= 0);t=t->next ) n++;
+   while ( n-- && (gui->timers != NULL) && ((UG_S32)(now - gui->timers->due) >= 0) )
+   {
+      t = gui->timers;
+      gui->timers = t->next;
+      if ( t->period )
+      {
+         /* Missed periods are skipped */
+         t->due += t->period;
+         if ( (UG_S32)(now - t->due) >= 0 ) t->due = now + t->period;
+         _UG_TimerInsert( t );
+      }
+      t->cb( t );
+   }
+
+   for( tw=gui->tweens;tw!=NULL;tw=next )
+   {
+      next = tw->next;
+      v = _UG_TweenValue( tw, now );
+      if ( now - tw->start >= tw->duration ) UG_TweenStop( tw );
+      if ( v != tw->value )
+      {
+         tw->value = v;
+         tw->apply( tw, v );
+      }
+   }
+}
+
+/* Time at which UG_Update has to be called next. While a tween runs or the */
+/* GUI isn't idle (UG_IsIdle) this is the current time. Returns             */
+/* UG_RESULT_FAIL if nothing is waiting, the next call is due with input.   */
+/* Writes to bound variables aren't seen here, with bindings the caller has */
+/* to wake up for them or poll UG_IsIdle().                                 */
+UG_RESULT UG_GetNextDeadline( UG_U32* deadline )
+{
+   if ( (gui->clock == NULL) || (deadline == NULL) ) return UG_RESULT_FAIL;
+   if ( (gui->tweens != NULL) || !UG_IsIdle() )
+   {
+      *deadline = gui->clock();
+      return UG_RESULT_OK;
+   }
+   if ( gui->timers != NULL )
+   {
+      *deadline = gui->timers->due;
+      return UG_RESULT_OK;
+   }
+   return UG_RESULT_FAIL;
+}
+#endif
+
+/* -------------------------------------------------------------------------------- */
+/* -- TRACE FUNCTIONS                                                            -- */
+/* -------------------------------------------------------------------------------- */
+#ifdef USE_TRACE
+void _UG_Trace( UG_U8 phase, UG_U8 kind, UG_U8 a, UG_U8 b )
+{
+   UG_TRACE_EVENT* e;
+
+   if ( gui->clock == NULL ) return;
+   e = &gui->trace[gui->trace_head];
+   e->time = gui->clock();
+   e->phase = phase;
+   e->kind = kind;
+   e->a = a;
+   e->b = b;
+   if ( ++gui->trace_head == UG_TRACE_EVENTS ) gui->trace_head = 0;
+   if ( gui->trace_count < UG_TRACE_EVENTS ) gui->trace_count++;
+}
+
+void UG_TraceClear( void )
+{
+   gui->trace_head = 0;
+   gui->trace_count = 0;
+}
+
+void _UG_TraceNumber( void (*write)( const char* str ), UG_U32 v )
+{
+   char buf[11];
+   UG_U8 n;
+
+   n = 10;
+   buf[n] = 0;
+   do
+   {
+      buf[--n] = '0' + v % 10;
+      v /= 10;
+   } while ( v );
+   write( &buf[n] );
+}
+
+/* Writes the recorded events, oldest first, as Chrome trace JSON (for      */
+/* chrome://tracing or Perfetto) through write. The clock values are taken */
+/* as microseconds. End events whose begin was overwritten are left out.   */
+void UG_TraceDump( void (*write)( const char* str ) )
+{
+   static const char* const kinds[] = { "update", "window", "object", "driver", "event" };
+   static const char* const objects[] = { "object", "button", "textbox", "image", "checkbox" };
+   static const char* const drivers[] = { "draw line", "fill frame", "fill area" };
+   UG_TRACE_EVENT* e;
+   UG_U16 i,k,depth;
+   UG_U8 first;
+
+   if ( write == NULL ) return;
+   write( "{\"traceEvents\":[" );
+   k = ( gui->trace_head >= gui->trace_count ) ? gui->trace_head - gui->trace_count : gui->trace_head + UG_TRACE_EVENTS - gui->trace_count;
+   depth = 0;
+   first = 1;
+   for( i=0;i<gui->trace_count;i++ )
+   {
+      e = &gui->trace[k];
+      if ( ++k == UG_TRACE_EVENTS ) k = 0;
+      if ( e->phase == 'B' ) depth++;
+      else if ( depth ) depth--;
+      else continue;
 
+      write( first ? "\n{\"name\":\"" : ",\n{\"name\":\"" );
+      first = 0;
+      switch ( e->kind )
+      {
+         case TRACE_UPDATE:
+            write( "UG_Update" );
+            break;
+         case TRACE_WINDOW:
+            write( "window" );
+            break;
+         case TRACE_DRIVER:
+            write( ( e->a <= DRIVER_FILL_AREA ) ? drivers[e->a] : "driver" );
+            break;
+         default:
+            if ( e->kind == TRACE_EVENT ) write( "event " );
+            write( ( e->a <= OBJ_TYPE_CHECKBOX ) ? objects[e->a] : "object" );
+            write( " " );
+            _UG_TraceNumber( write, e->b );
+            break;
+      }
+      write( "\",\"cat\":\"" );
+      write( kinds[e->kind] );
+      write( ( e->phase == 'B' ) ? "\",\"ph\":\"B\",\"ts\":" : "\",\"ph\":\"E\",\"ts\":" );
+      _UG_TraceNumber( write, e->time );
+      write( ",\"pid\":1,\"tid\":1}" );
+   }
+   write( "\n]}\n" );
+}
+#endif
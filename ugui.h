@@ -28,10 +28,61 @@
 typedef enum
 {
 	FONT_TYPE_1BPP,
-	FONT_TYPE_8BPP
+	FONT_TYPE_8BPP,
+	FONT_TYPE_1BPP_RLE,
+	FONT_TYPE_4BPP,
+	FONT_TYPE_2BPP
 } FONT_TYPE;
 
+/* FONT_TYPE_1BPP_RLE: Each glyph starts at p[offsets[glyph]] and is a stream  */
+/* of 4 bit codes (high nibble first). Every row starts with a repeat count   */
+/* (number of following rows which are identical), followed by alternating   */
+/* background/foreground run lengths, starting with background. A run code of */
+/* 15 adds 15 pixels to the current run. A zero run code ends the row with    */
+/* background, unless it is the first run of the row.                         */
+
+/* FONT_TYPE_4BPP / FONT_TYPE_2BPP: Anti-aliased glyphs with 16 / 4 coverage  */
+/* levels per pixel (0 = background, 15 / 3 = foreground), packed high bits   */
+/* first. Every row starts at a byte boundary. With offsets each glyph starts */
+/* at p[offsets[glyph]] and its rows are as wide as the glyph (widths), so    */
+/* proportional glyphs don't waste the space of char_width.                   */
+
+/* Range of consecutive characters in a sparse font. The glyphs of the range */
+/* start at glyph index "glyph". Ranges have to be sorted by their codes.    */
+typedef struct
+{
+   UG_U16 first;
+   UG_U16 last;
+   UG_U16 glyph;
+} UG_FONT_RANGE;
+
+/* Ink box of a glyph inside its cell. Fonts with bboxes only store the     */
+/* pixels of the box (rows of w pixels) at p[offsets[glyph]]. Empty glyphs */
+/* have w = h = 0.                                                          */
 typedef struct
+{
+   UG_U8 x;
+   UG_U8 y;
+   UG_U8 w;
+   UG_U8 h;
+} UG_FONT_BBOX;
+
+/* Glyph index of characters which are not part of a font */
+#define FONT_NO_GLYPH                                 0xFFFF
+
+/* Dense fonts contain the characters start_char..end_char (code page 437).  */
+/* If ranges is set, the font contains the Unicode characters of the ranges. */
+/* offsets has one entry more than the font has glyphs, the last one is the  */
+/* size of the glyph data, so every glyph ends where the next one starts.    */
+/* Fonts with a read function keep their glyph data outside of the address   */
+/* space (e.g. in SPI flash). Glyphs are then read on demand into the glyph  */
+/* cache (USE_FONT_PAGING) and p only identifies the font for read, so it    */
+/* has to be unique. read returns 0 (UG_RESULT_OK) on success. It is never  */
+/* asked for bytes beyond the glyph data.                                    */
+/* A scale of 2 or more magnifies the font, e.g. a copy of FONT_8X12 with   */
+/* scale 3 draws 24x36 characters from the same data (0 and 1 = native).    */
+typedef struct S_FONT                                 UG_FONT;
+struct S_FONT
 {
    unsigned char* p;
    FONT_TYPE font_type;
@@ -40,7 +91,31 @@ typedef struct
    UG_U16 start_char;
    UG_U16 end_char;
    UG_U8  *widths;
-} UG_FONT;
+   const UG_U32* offsets;
+   const UG_FONT_RANGE* ranges;
+   UG_U16 range_count;
+   UG_S8 (*read)( const UG_FONT* font, UG_U32 offset, UG_U8* buf, UG_U16 len );
+   const UG_FONT_BBOX* bboxes;
+   UG_U8 scale;
+};
+
+/* Glyph cache of paged fonts */
+#ifdef USE_FONT_PAGING
+#ifndef UG_FONT_CACHE_SLOTS
+#define UG_FONT_CACHE_SLOTS                           16
+#endif
+#ifndef UG_FONT_CACHE_SLOT_SIZE
+#define UG_FONT_CACHE_SLOT_SIZE                       256
+#endif
+
+typedef struct
+{
+   const unsigned char* p;
+   UG_U32 offset;
+   UG_U32 stamp;
+   UG_U8 data[UG_FONT_CACHE_SLOT_SIZE];
+} UG_FONT_CACHE_SLOT;
+#endif
 
 #ifdef USE_FONT_4X6
    extern const UG_FONT FONT_4X6;
@@ -130,6 +205,15 @@ typedef UG_U16                                        UG_COLOR;
 #define ALIGN_TOP_CENTER                              (ALIGN_V_TOP|ALIGN_H_CENTER)
 #define ALIGN_TOP_LEFT                                (ALIGN_V_TOP|ALIGN_H_LEFT)
 
+/* Features which need the clock given to UG_SetClock */
+#if defined(USE_UPDATE_BUDGET) || defined(USE_TIMER) || defined(USE_STATS) || defined(USE_TRACE)
+#define USE_CLOCK
+#endif
+
+/* Number formats (UG_FormatNumber) */
+#define NUM_SIGN_PLUS                                 (1<<0)
+#define NUM_PAD_ZERO                                  (1<<1)
+
 /* Default IDs */
 #define OBJ_ID_0                                      0
 #define OBJ_ID_1                                      1
@@ -170,6 +254,35 @@ typedef struct
    UG_S16 ye;
 } UG_AREA;
 
+/* Number of lines kept in a text layout, further lines are measured on the fly */
+#ifndef UG_TEXT_LAYOUT_LINES
+#define UG_TEXT_LAYOUT_LINES                          4
+#endif
+
+/* Text layout structure. It caches the line breaks and positions of a text */
+/* and is rebuilt when the string, font or area changes. The string is      */
+/* compared by a hash, so a buffer which is changed in place is detected.   */
+typedef struct
+{
+   UG_U8 valid;
+   char* str;
+   UG_U32 hash;
+   const unsigned char* font_p;
+   UG_U8 font_scale;
+   UG_AREA a;
+   UG_S16 y;
+   UG_U16 lines;
+   struct
+   {
+      UG_U16 start;
+      UG_U16 len;
+      UG_S16 x;
+      UG_S16 w;
+      UG_U8 ellipsis;
+   } line[UG_TEXT_LAYOUT_LINES];
+   UG_U16 rest;
+} UG_TEXT_LAYOUT;
+
 /* Text structure */
 typedef struct
 {
@@ -179,10 +292,21 @@ typedef struct
    UG_COLOR fc;
    UG_COLOR bc;
    UG_U8 align;
+   UG_U8 style;
    UG_S16 h_space;
    UG_S16 v_space;
+   UG_TEXT_LAYOUT* layout;
 } UG_TEXT;
 
+/* Text styles */
+#define TXT_STYLE_TRANSPARENT                         (1<<0)
+#define TXT_STYLE_WORD_WRAP                           (1<<1)
+#define TXT_STYLE_ELLIPSIS                            (1<<2)
+/* The area has been filled with bc, so transparent text may be drawn opaque */
+#define TXT_STYLE_FILLED                              (1<<3)
+/* The text changes often, it isn't kept in the label cache */
+#define TXT_STYLE_NO_CACHE                            (1<<4)
+
 /* -------------------------------------------------------------------------------- */
 /* -- BITMAP                                                                     -- */
 /* -------------------------------------------------------------------------------- */
@@ -193,6 +317,8 @@ typedef struct
    UG_U16 height;
    UG_U8 bpp;
    UG_U8 colors;
+   const void* pal;
+   UG_U8 comp;
 } UG_BMP;
 
 #define BMP_BPP_1                                     (1<<0)
@@ -204,6 +330,110 @@ typedef struct
 #define BMP_RGB888                                    (1<<0)
 #define BMP_RGB565                                    (1<<1)
 #define BMP_RGB555                                    (1<<2)
+#define BMP_BYTE_SWAP                                 (1<<3)
+
+/* Indexed bitmaps (BMP_BPP_1 ... BMP_BPP_8) need a palette with 2^bpp entries */
+/* stored in the format given by 'colors'. Pixels are packed MSB first and     */
+/* every row starts at a byte boundary.                                        */
+
+/* Compression schemes */
+#define BMP_COMP_NONE                                 0
+#define BMP_COMP_RLE                                  1
+#define BMP_COMP_QOI                                  2
+
+/* BMP_COMP_RLE: A stream of packets. Header byte h with bit 7 set is followed */
+/* by one pixel, which is repeated (h&0x7F)+1 times. Otherwise h+1 literal     */
+/* pixels follow. Pixels use the byte layout of uncompressed 8, 16 or 32 bpp   */
+/* bitmaps (little endian). Packets may cross row boundaries.                  */
+/* BMP_COMP_QOI: The chunk stream of the "Quite OK Image" format without its   */
+/* header and end marker. It always decodes to RGB888 (bpp = BMP_BPP_32).      */
+
+/* Number of pixels converted per chunk by UG_DrawBMP() */
+#define BMP_CHUNK_SIZE                                32
+
+/* -------------------------------------------------------------------------------- */
+/* -- ASSET PACK                                                                 -- */
+/* -------------------------------------------------------------------------------- */
+/* A pack holds fonts, bitmaps and palettes in one binary image, which is used  */
+/* in place (e.g. memory mapped or in flash). It starts with a UG_PACK_HEADER,   */
+/* followed by 'count' UG_PACK_ENTRYs. Each entry points to the record of an     */
+/* asset, which in turn points to its data. Values are little endian, records    */
+/* and data blocks are 4 byte aligned and offsets count from the pack start.     */
+/* All parts of an asset lie inside offset..offset+size of its entry.            */
+#define PACK_MAGIC                                    0x4B504755 /* "UGPK" */
+#define PACK_VERSION                                  1
+#define PACK_NAME_LENGTH                              16
+
+/* Asset types */
+#define PACK_TYPE_FONT                                1
+#define PACK_TYPE_BMP                                 2
+#define PACK_TYPE_PALETTE                             3
+
+typedef struct
+{
+   UG_U32 magic;
+   UG_U16 version;
+   UG_U16 count;
+   UG_U32 size;
+   UG_U32 reserved;
+} UG_PACK_HEADER;
+
+typedef struct
+{
+   char name[PACK_NAME_LENGTH];
+   UG_U16 type;
+   UG_U16 reserved;
+   UG_U32 offset;
+   UG_U32 size;
+   UG_U32 reserved2;
+} UG_PACK_ENTRY;
+
+/* PACK_TYPE_FONT record. widths, offsets and ranges are 0 if not used */
+typedef struct
+{
+   UG_U8 font_type;
+   UG_U8 reserved;
+   UG_U16 char_width;
+   UG_U16 char_height;
+   UG_U16 start_char;
+   UG_U16 end_char;
+   UG_U16 range_count;
+   UG_U32 data;
+   UG_U32 widths;
+   UG_U32 offsets;
+   UG_U32 ranges;
+} UG_PACK_FONT;
+
+/* PACK_TYPE_BMP record. pal is 0 for bitmaps without palette */
+typedef struct
+{
+   UG_U16 width;
+   UG_U16 height;
+   UG_U8 bpp;
+   UG_U8 colors;
+   UG_U8 comp;
+   UG_U8 reserved;
+   UG_U32 data;
+   UG_U32 pal;
+} UG_PACK_BMP;
+
+/* PACK_TYPE_PALETTE record */
+typedef struct
+{
+   UG_U16 count;
+   UG_U8 colors;
+   UG_U8 reserved;
+   UG_U32 data;
+} UG_PACK_PALETTE;
+
+/* Opened pack */
+typedef struct
+{
+   const UG_U8* data;
+   UG_U32 size;
+   UG_U16 count;
+   const UG_PACK_ENTRY* index;
+} UG_PACK;
 
 /* -------------------------------------------------------------------------------- */
 /* -- MESSAGE                                                                    -- */
@@ -232,6 +462,7 @@ typedef struct
    UG_U8 state;
    UG_S16 xp;
    UG_S16 yp;
+   UG_U8 pending;
 } UG_TOUCH;
 
 
@@ -253,6 +484,9 @@ struct S_OBJECT
    UG_U8 id;                                 /* object ID                                  */
    UG_U8 event;                              /* object-specific events                     */
    void* data;                               /* pointer to object-specific data            */
+#ifdef USE_UPDATE_BUDGET
+   UG_U8 priority;                           /* pending redraws of higher ones come first  */
+#endif
 };
 
 /* Currently supported objects */
@@ -304,6 +538,7 @@ struct S_OBJECT
 typedef struct
 {
    char* str;
+   UG_U32 str_hash;
    const UG_FONT* font;
    UG_S8 h_space;
    UG_S8 v_space;
@@ -313,6 +548,7 @@ typedef struct
    UG_COLOR ifc;
    UG_COLOR ibc;
    UG_U8 height;
+   UG_TEXT_LAYOUT layout;
 } UG_TITLE;
 
 /* Window structure */
@@ -364,6 +600,8 @@ typedef struct
    UG_S8 h_space;
    UG_S8 v_space;
    char* str;
+   UG_U32 str_hash;
+   UG_TEXT_LAYOUT layout;
 }UG_BUTTON;
 
 /* Default button IDs */
@@ -400,6 +638,8 @@ typedef struct
 #define BTN_STYLE_USE_ALTERNATE_COLORS                (1<<2)
 #define BTN_STYLE_NO_BORDERS                          (1<<3)
 #define BTN_STYLE_NO_FILL                             (1<<4)
+#define BTN_STYLE_WORD_WRAP                           (1<<5)
+#define BTN_STYLE_ELLIPSIS                            (1<<6)
 
 /* Button events */
 #define BTN_EVENT_CLICKED                             OBJ_EVENT_CLICKED
@@ -421,7 +661,9 @@ typedef struct
    UG_S8 h_space;
    UG_S8 v_space;
    char* str;
+   UG_U32 str_hash;
    UG_U8 checked;
+   UG_TEXT_LAYOUT layout;
 }UG_CHECKBOX;
 
 /* Default checkbox IDs */
@@ -466,10 +708,25 @@ typedef struct
 /* -------------------------------------------------------------------------------- */
 /* -- TEXTBOX OBJECT                                                             -- */
 /* -------------------------------------------------------------------------------- */
+/* Longest string which is kept to redraw only the changed characters */
+#ifdef USE_TEXTBOX_DIFF
+#ifndef UG_TEXTBOX_DIFF_LENGTH
+#define UG_TEXTBOX_DIFF_LENGTH                        32
+#endif
+#endif
+
+/* Longest number of a textbox (UG_TextboxSetNumber), terminator included */
+#ifdef USE_TEXTBOX_NUMBER
+#ifndef UG_TEXTBOX_NUMBER_LENGTH
+#define UG_TEXTBOX_NUMBER_LENGTH                      16
+#endif
+#endif
+
 /* Textbox structure */
 typedef struct
 {
    char* str;
+   UG_U32 str_hash;
    const UG_FONT* font;
    UG_U8 style;
    UG_COLOR fc;
@@ -477,6 +734,18 @@ typedef struct
    UG_U8 align;
    UG_S8 h_space;
    UG_S8 v_space;
+   UG_TEXT_LAYOUT layout;
+#ifdef USE_TEXTBOX_DIFF
+   char last[UG_TEXTBOX_DIFF_LENGTH];
+   UG_U8 last_valid;
+#endif
+#ifdef USE_TEXTBOX_NUMBER
+   char num[UG_TEXTBOX_NUMBER_LENGTH];
+   char num_last[UG_TEXTBOX_NUMBER_LENGTH];
+#endif
+#ifdef USE_LABEL_CACHE
+   UG_U32 drawn_hash;
+#endif
 } UG_TEXTBOX;
 
 /* Default textbox IDs */
@@ -501,6 +770,10 @@ typedef struct
 #define TXB_ID_18                                     OBJ_ID_18
 #define TXB_ID_19                                     OBJ_ID_19
 
+/* Textbox style */
+#define TXB_STYLE_WORD_WRAP                           (1<<0)
+#define TXB_STYLE_ELLIPSIS                            (1<<1)
+
 /* -------------------------------------------------------------------------------- */
 /* -- IMAGE OBJECT                                                               -- */
 /* -------------------------------------------------------------------------------- */
@@ -536,6 +809,69 @@ typedef struct
 /* Image types */
 #define IMG_TYPE_BMP                                  (1<<0)
 
+/* -------------------------------------------------------------------------------- */
+/* -- VALUE BINDING                                                              -- */
+/* -------------------------------------------------------------------------------- */
+/* A binding shows a variable in the text of a textbox, button or checkbox.  */
+/* UG_Update formats the value with the format callback and sets the text   */
+/* only if the formatted string has changed.                                */
+#ifdef USE_BINDING
+#ifndef UG_BINDING_LENGTH
+#define UG_BINDING_LENGTH                             16
+#endif
+
+typedef struct S_BINDING                              UG_BINDING;
+struct S_BINDING
+{
+   UG_WINDOW* wnd;
+   UG_U8 type;
+   UG_U8 id;
+   const void* value;
+   void (*format)( char* str, UG_U16 size, const void* value );
+   char str[UG_BINDING_LENGTH];
+   UG_BINDING* next;
+};
+#endif
+
+/* -------------------------------------------------------------------------------- */
+/* -- TIMERS AND TWEENS                                                          -- */
+/* -------------------------------------------------------------------------------- */
+/* Timers and tweens are run by UG_Update with the time of the clock given   */
+/* to UG_SetClock. A tween moves a value from one number to another over a   */
+/* duration and calls apply whenever it changes; applied through the object  */
+/* setters only what the new value changes is redrawn.                       */
+#ifdef USE_TIMER
+typedef struct S_TIMER                                UG_TIMER;
+struct S_TIMER
+{
+   UG_U32 due;
+   UG_U32 period;
+   void (*cb)( UG_TIMER* t );
+   void* data;
+   UG_TIMER* next;
+};
+
+typedef struct S_TWEEN                                UG_TWEEN;
+struct S_TWEEN
+{
+   UG_U32 start;
+   UG_U32 duration;
+   UG_S32 from;
+   UG_S32 to;
+   UG_S32 value;
+   UG_U8 curve;
+   void (*apply)( UG_TWEEN* tw, UG_S32 value );
+   void* data;
+   UG_TWEEN* next;
+};
+
+/* Tween curves */
+#define TWEEN_LINEAR                                  0
+#define TWEEN_EASE_IN                                 1
+#define TWEEN_EASE_OUT                                2
+#define TWEEN_EASE_IN_OUT                             3
+#endif
+
 /* -------------------------------------------------------------------------------- */
 /* -- µGUI DRIVER                                                                -- */
 /* -------------------------------------------------------------------------------- */
@@ -557,6 +893,105 @@ typedef struct
 /* -------------------------------------------------------------------------------- */
 /* -- µGUI CORE STRUCTURE                                                        -- */
 /* -------------------------------------------------------------------------------- */
+/* Blended colors of the coverage levels of anti-aliased fonts, cached per */
+/* color pair. UG_BLEND_CACHE_LEVELS = 256 also covers FONT_TYPE_8BPP.     */
+#ifdef USE_BLEND_CACHE
+#ifndef UG_BLEND_CACHE_SLOTS
+#define UG_BLEND_CACHE_SLOTS                          4
+#endif
+#ifndef UG_BLEND_CACHE_LEVELS
+#define UG_BLEND_CACHE_LEVELS                         16
+#endif
+
+typedef struct
+{
+   UG_COLOR fc;
+   UG_COLOR bc;
+   UG_U16 levels;
+   UG_U32 stamp;
+   UG_COLOR lut[UG_BLEND_CACHE_LEVELS];
+} UG_BLEND_CACHE_SLOT;
+#endif
+
+/* Rendered text blocks, cached per string, font, colors and text area.     */
+/* UG_LABEL_CACHE_SLOT_SIZE is the size of a slot in pixels, larger blocks  */
+/* are drawn directly. The cache takes SLOTS * SLOT_SIZE colors of RAM.     */
+#ifdef USE_LABEL_CACHE
+#ifndef UG_LABEL_CACHE_SLOTS
+#define UG_LABEL_CACHE_SLOTS                          8
+#endif
+#ifndef UG_LABEL_CACHE_SLOT_SIZE
+#define UG_LABEL_CACHE_SLOT_SIZE                      2048
+#endif
+
+typedef struct
+{
+   UG_U32 hash;
+   const unsigned char* font_p;
+   UG_U8 font_scale;
+   UG_COLOR fc;
+   UG_COLOR bc;
+   UG_S16 aw;
+   UG_S16 ah;
+   UG_U8 align;
+   UG_U8 style;
+   UG_S16 h_space;
+   UG_S16 v_space;
+   UG_S16 x;
+   UG_S16 y;
+   UG_U16 w;
+   UG_U16 h;
+   UG_U32 stamp;
+   UG_COLOR px[UG_LABEL_CACHE_SLOT_SIZE];
+} UG_LABEL_CACHE_SLOT;
+#endif
+
+/* Counters of the drawing work since the last UG_GetStats(). The times are */
+/* measured with the clock given to UG_SetClock.                            */
+#ifdef USE_STATS
+typedef struct
+{
+   UG_U32 updates;                           /* calls of UG_Update                         */
+   UG_U32 psets;                             /* pixels set through pset                    */
+   UG_U32 push_bytes;                        /* bytes pushed to fill area windows          */
+   UG_U32 driver_calls[NUMBER_OF_DRIVERS];   /* calls of each driver                       */
+   UG_U32 fill_pixels;                       /* pixels of filled frames                    */
+   UG_U32 line_pixels;                       /* pixels of lines                            */
+   UG_U32 bmp_pixels;                        /* pixels of bitmaps                          */
+   UG_U32 glyphs;                            /* glyphs drawn                               */
+   UG_U32 glyph_pixels;                      /* pixels of the glyph cells                  */
+   UG_U32 objects;                           /* calls of object update functions           */
+   UG_U32 time_touch;                        /* time of the touch processing               */
+   UG_U32 time_update;                       /* time of the window and object updates      */
+   UG_U32 time_events;                       /* time of the event callbacks                */
+} UG_STATS;
+#endif
+
+/* Begin and end events of UG_Update, the window and object updates, the   */
+/* driver calls and the event callbacks, kept in a ring buffer of the last */
+/* UG_TRACE_EVENTS events. UG_TraceDump writes them as Chrome trace JSON.  */
+#ifdef USE_TRACE
+#ifndef UG_TRACE_EVENTS
+#define UG_TRACE_EVENTS                               256
+#endif
+
+typedef struct
+{
+   UG_U32 time;
+   UG_U8 phase;
+   UG_U8 kind;
+   UG_U8 a;
+   UG_U8 b;
+} UG_TRACE_EVENT;
+
+/* Trace event kinds */
+#define TRACE_UPDATE                                  0
+#define TRACE_WINDOW                                  1
+#define TRACE_OBJECT                                  2
+#define TRACE_DRIVER                                  3
+#define TRACE_EVENT                                   4
+#endif
+
 typedef struct
 {
    void (*pset)(UG_S16,UG_S16,UG_COLOR);
@@ -580,6 +1015,57 @@ typedef struct
    UG_FONT font;
    UG_S8 char_h_space;
    UG_S8 char_v_space;
+   UG_U8 transparent_font;
+   const UG_FONT_RANGE* last_ranges;
+   UG_U16 last_range;
+#ifdef USE_FONT_PAGING
+   UG_FONT_CACHE_SLOT font_cache[UG_FONT_CACHE_SLOTS];
+   UG_U32 font_cache_clock;
+   UG_U32 font_cache_hits;
+   UG_U32 font_cache_misses;
+#endif
+#ifdef USE_BLEND_CACHE
+   UG_BLEND_CACHE_SLOT blend_cache[UG_BLEND_CACHE_SLOTS];
+   UG_U32 blend_cache_clock;
+   UG_U32 blend_cache_hits;
+   UG_U32 blend_cache_misses;
+#endif
+#ifdef USE_BMP_PALETTE_LUT
+   UG_COLOR bmp_lut[256];
+#endif
+#ifdef USE_BINDING
+   UG_BINDING* bindings;
+#endif
+#ifdef USE_LABEL_CACHE
+   UG_LABEL_CACHE_SLOT label_cache[UG_LABEL_CACHE_SLOTS];
+   UG_U32 label_cache_clock;
+   UG_U32 label_cache_hits;
+   UG_U32 label_cache_misses;
+   UG_LABEL_CACHE_SLOT* label_capture;
+   UG_S16 label_capture_x;
+   UG_S16 label_capture_y;
+#endif
+#ifdef USE_CLOCK
+   UG_U32 (*clock)( void );
+   UG_U32 update_start;
+#endif
+#ifdef USE_UPDATE_BUDGET
+   UG_U32 update_budget;
+#endif
+#ifdef USE_TIMER
+   UG_TIMER* timers;
+   UG_TWEEN* tweens;
+#endif
+#ifdef USE_STATS
+   UG_STATS stats;
+   void (*stats_pset)(UG_S16,UG_S16,UG_COLOR);
+   UG_U32 stats_lap;
+#endif
+#ifdef USE_TRACE
+   UG_TRACE_EVENT trace[UG_TRACE_EVENTS];
+   UG_U16 trace_head;
+   UG_U16 trace_count;
+#endif
    UG_COLOR fore_color;
    UG_COLOR back_color;
    UG_COLOR desktop_color;
@@ -907,12 +1393,48 @@ UG_S16 UG_GetXDim( void );
 UG_S16 UG_GetYDim( void );
 void UG_FontSetHSpace( UG_U16 s );
 void UG_FontSetVSpace( UG_U16 s );
+void UG_FontSetTransparency( UG_U8 t );
+#ifdef USE_FONT_PAGING
+void UG_FontCacheFlush( void );
+void UG_FontCacheGetStats( UG_U32* hits, UG_U32* misses );
+#endif
+#ifdef USE_BLEND_CACHE
+void UG_BlendCacheGetStats( UG_U32* hits, UG_U32* misses );
+#endif
+#ifdef USE_LABEL_CACHE
+void UG_LabelCacheFlush( void );
+void UG_LabelCacheGetStats( UG_U32* hits, UG_U32* misses );
+#endif
 
 /* Miscellaneous functions */
 void UG_WaitForUpdate( void );
 void UG_Update( void );
 void UG_DrawBMP( UG_S16 xp, UG_S16 yp, UG_BMP* bmp );
 void UG_TouchUpdate( UG_S16 xp, UG_S16 yp, UG_U8 state );
+UG_U8 UG_IsIdle( void );
+UG_U8 UG_FormatNumber( char* str, UG_U8 size, UG_S32 value, UG_U8 width, UG_U8 decimals, UG_U8 flags );
+#ifdef USE_CLOCK
+void UG_SetClock( UG_U32 (*clock)( void ) );
+#endif
+#ifdef USE_STATS
+void UG_GetStats( UG_STATS* stats );
+#endif
+#ifdef USE_TRACE
+void UG_TraceClear( void );
+void UG_TraceDump( void (*write)( const char* str ) );
+#endif
+#ifdef USE_UPDATE_BUDGET
+void UG_SetUpdateBudget( UG_U32 budget );
+UG_RESULT UG_ObjectSetPriority( UG_WINDOW* wnd, UG_U8 type, UG_U8 id, UG_U8 priority );
+#endif
+
+/* Asset pack functions */
+#ifdef USE_ASSET_PACK
+UG_RESULT UG_PackOpen( UG_PACK* pack, const void* data, UG_U32 size );
+UG_RESULT UG_PackGetFont( const UG_PACK* pack, const char* name, UG_FONT* font );
+UG_RESULT UG_PackGetBMP( const UG_PACK* pack, const char* name, UG_BMP* bmp );
+UG_RESULT UG_PackGetPalette( const UG_PACK* pack, const char* name, const void** pal, UG_U16* count, UG_U8* colors );
+#endif
 
 /* Driver functions */
 void UG_DriverRegister( UG_U8 type, void* driver );
@@ -1032,6 +1554,10 @@ UG_RESULT UG_TextboxSetFont( UG_WINDOW* wnd, UG_U8 id, const UG_FONT* font );
 UG_RESULT UG_TextboxSetHSpace( UG_WINDOW* wnd, UG_U8 id, UG_S8 hs );
 UG_RESULT UG_TextboxSetVSpace( UG_WINDOW* wnd, UG_U8 id, UG_S8 vs );
 UG_RESULT UG_TextboxSetAlignment( UG_WINDOW* wnd, UG_U8 id, UG_U8 align );
+UG_RESULT UG_TextboxSetStyle( UG_WINDOW* wnd, UG_U8 id, UG_U8 style );
+#ifdef USE_TEXTBOX_NUMBER
+UG_RESULT UG_TextboxSetNumber( UG_WINDOW* wnd, UG_U8 id, UG_S32 value, UG_U8 width, UG_U8 decimals, UG_U8 flags );
+#endif
 UG_COLOR UG_TextboxGetForeColor( UG_WINDOW* wnd, UG_U8 id );
 UG_COLOR UG_TextboxGetBackColor( UG_WINDOW* wnd, UG_U8 id );
 char* UG_TextboxGetText( UG_WINDOW* wnd, UG_U8 id );
@@ -1039,6 +1565,7 @@ UG_FONT* UG_TextboxGetFont( UG_WINDOW* wnd, UG_U8 id );
 UG_S8 UG_TextboxGetHSpace( UG_WINDOW* wnd, UG_U8 id );
 UG_S8 UG_TextboxGetVSpace( UG_WINDOW* wnd, UG_U8 id );
 UG_U8 UG_TextboxGetAlignment( UG_WINDOW* wnd, UG_U8 id );
+UG_U8 UG_TextboxGetStyle( UG_WINDOW* wnd, UG_U8 id );
 
 /* Image functions */
 UG_RESULT UG_ImageCreate( UG_WINDOW* wnd, UG_IMAGE* img, UG_U8 id, UG_S16 xs, UG_S16 ys, UG_S16 xe, UG_S16 ye );
@@ -1047,6 +1574,21 @@ UG_RESULT UG_ImageShow( UG_WINDOW* wnd, UG_U8 id );
 UG_RESULT UG_ImageHide( UG_WINDOW* wnd, UG_U8 id );
 UG_RESULT UG_ImageSetBMP( UG_WINDOW* wnd, UG_U8 id, const UG_BMP* bmp );
 
+/* Binding functions */
+#ifdef USE_BINDING
+UG_RESULT UG_BindingCreate( UG_BINDING* b, UG_WINDOW* wnd, UG_U8 type, UG_U8 id, const void* value, void (*format)( char* str, UG_U16 size, const void* value ) );
+UG_RESULT UG_BindingDelete( UG_BINDING* b );
+#endif
+
+/* Timer functions */
+#ifdef USE_TIMER
+UG_RESULT UG_TimerStart( UG_TIMER* t, UG_U32 delay, UG_U32 period, void (*cb)( UG_TIMER* t ), void* data );
+UG_RESULT UG_TimerStop( UG_TIMER* t );
+UG_RESULT UG_TweenStart( UG_TWEEN* tw, UG_S32 from, UG_S32 to, UG_U32 duration, UG_U8 curve, void (*apply)( UG_TWEEN* tw, UG_S32 value ), void* data );
+UG_RESULT UG_TweenStop( UG_TWEEN* tw );
+UG_RESULT UG_GetNextDeadline( UG_U32* deadline );
+#endif
+
 
 
 #endif
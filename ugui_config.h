@@ -1,63 +1,115 @@
-#ifndef __UGUI_CONFIG_H
-#define __UGUI_CONFIG_H
-
-/* -------------------------------------------------------------------------------- */
-/* -- CONFIG SECTION                                                             -- */
-/* -------------------------------------------------------------------------------- */
-
-//#define USE_MULTITASKING    
-
-/* Enable color mode */
-#define USE_COLOR_RGB888   // RGB = 0xFF,0xFF,0xFF
-//#define USE_COLOR_RGB565   // RGB = 0bRRRRRGGGGGGBBBBB 
-
-/* Enable needed fonts here */
-//#define  USE_FONT_4X6
-//#define  USE_FONT_5X8
-//#define  USE_FONT_5X12
-//#define  USE_FONT_6X8
-//#define  USE_FONT_6X10
-//#define  USE_FONT_7X12
-//#define  USE_FONT_8X8
-//#define  USE_FONT_8X12_CYRILLIC
-//#define  USE_FONT_8X12
-//#define  USE_FONT_8X12
-//#define  USE_FONT_8X14
-//#define  USE_FONT_10X16
-//#define  USE_FONT_12X16
-//#define  USE_FONT_12X20
-//#define  USE_FONT_16X26
-//#define  USE_FONT_22X36
-//#define  USE_FONT_24X40
-//#define  USE_FONT_32X53
-
-/* Specify platform-dependent integer types here */
-
-#define __UG_FONT_DATA const
-typedef uint8_t      UG_U8;
-typedef int8_t       UG_S8;
-typedef uint16_t     UG_U16;
-typedef int16_t      UG_S16;
-typedef uint32_t     UG_U32;
-typedef int32_t      UG_S32;
-
-
-/* Example for dsPIC33
-typedef unsigned char         UG_U8;
-typedef signed char           UG_S8;
-typedef unsigned int          UG_U16;
-typedef signed int            UG_S16;
-typedef unsigned long int     UG_U32;
-typedef signed long int       UG_S32;
-*/
-
-/* -------------------------------------------------------------------------------- */
-/* -------------------------------------------------------------------------------- */
-
-
-/* Feature enablers */
-#define USE_PRERENDER_EVENT
-#define USE_POSTRENDER_EVENT
-
-
-#endif
+#ifndef __UGUI_CONFIG_H
+#define __UGUI_CONFIG_H
+
+/* -------------------------------------------------------------------------------- */
+/* -- CONFIG SECTION                                                             -- */
+/* -------------------------------------------------------------------------------- */
+
+//#define USE_MULTITASKING    
+
+/* Enable color mode */
+#define USE_COLOR_RGB888   // RGB = 0xFF,0xFF,0xFF
+//#define USE_COLOR_RGB565   // RGB = 0bRRRRRGGGGGGBBBBB 
+
+/* Enable needed fonts here */
+//#define  USE_FONT_4X6
+//#define  USE_FONT_5X8
+//#define  USE_FONT_5X12
+//#define  USE_FONT_6X8
+//#define  USE_FONT_6X10
+//#define  USE_FONT_7X12
+//#define  USE_FONT_8X8
+//#define  USE_FONT_8X12_CYRILLIC
+//#define  USE_FONT_8X12
+//#define  USE_FONT_8X12
+//#define  USE_FONT_8X14
+//#define  USE_FONT_10X16
+//#define  USE_FONT_12X16
+//#define  USE_FONT_12X20
+//#define  USE_FONT_16X26
+//#define  USE_FONT_22X36
+//#define  USE_FONT_24X40
+//#define  USE_FONT_32X53
+
+/* Specify platform-dependent integer types here */
+
+#define __UG_FONT_DATA const
+typedef uint8_t      UG_U8;
+typedef int8_t       UG_S8;
+typedef uint16_t     UG_U16;
+typedef int16_t      UG_S16;
+typedef uint32_t     UG_U32;
+typedef int32_t      UG_S32;
+
+
+/* Example for dsPIC33
+typedef unsigned char         UG_U8;
+typedef signed char           UG_S8;
+typedef unsigned int          UG_U16;
+typedef signed int            UG_S16;
+typedef unsigned long int     UG_U32;
+typedef signed long int       UG_S32;
+*/
+
+/* -------------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------------- */
+
+
+/* Feature enablers */
+#define USE_PRERENDER_EVENT
+#define USE_POSTRENDER_EVENT
+
+/* Decode strings as UTF-8 instead of single byte characters */
+//#define USE_UTF8
+
+/* Read glyphs of fonts with a read function through an LRU glyph cache.  */
+/* Size it with UG_FONT_CACHE_SLOTS and UG_FONT_CACHE_SLOT_SIZE (bytes,   */
+/* has to hold the largest glyph).                                        */
+//#define USE_FONT_PAGING
+
+/* Cache the blended colors of anti-aliased fonts per color pair. Size it */
+/* with UG_BLEND_CACHE_SLOTS and UG_BLEND_CACHE_LEVELS.                   */
+//#define USE_BLEND_CACHE
+
+/* Convert the palette of 8 bpp bitmaps once into a table of 256 colors in */
+/* UG_GUI. Otherwise their pixels are converted one by one, unless the     */
+/* palette is stored in the native color format.                           */
+//#define USE_BMP_PALETTE_LUT
+
+/* Keep rendered window titles, buttons and textboxes and copy them on a   */
+/* redraw. Size it with UG_LABEL_CACHE_SLOTS and UG_LABEL_CACHE_SLOT_SIZE. */
+//#define USE_LABEL_CACHE
+
+/* Redraw only the characters of a textbox which have changed. Strings up */
+/* to UG_TEXTBOX_DIFF_LENGTH - 1 characters are kept for the comparison.  */
+//#define USE_TEXTBOX_DIFF
+
+/* Let textboxes show numbers (UG_TextboxSetNumber). The digits are drawn */
+/* in fixed cells, a new value only redraws the digits which changed.    */
+//#define USE_TEXTBOX_NUMBER
+
+/* Let UG_Update() stop redrawing objects when a time budget is used up */
+/* (UG_SetUpdateBudget, timed with UG_SetClock), the rest is drawn by   */
+/* the next calls.                                                      */
+//#define USE_UPDATE_BUDGET
+
+/* Run timers and tweens (animated values) in UG_Update(), see UG_SetClock */
+//#define USE_TIMER
+
+/* Count the drawing work for UG_GetStats(). The time per phase of          */
+/* UG_Update() is measured with the clock given to UG_SetClock().          */
+//#define USE_STATS
+
+/* Record the phases of UG_Update() in a ring buffer which UG_TraceDump() */
+/* writes as Chrome trace JSON. The events are timed with UG_SetClock(). */
+//#define USE_TRACE
+
+/* Bind variables to the text of objects (UG_BindingCreate). Formatted */
+/* strings have up to UG_BINDING_LENGTH - 1 characters.                */
+//#define USE_BINDING
+
+/* Load fonts and bitmaps from asset packs (see tools/ugui_pack.c) */
+//#define USE_ASSET_PACK
+
+
+#endif